@@ -1,22 +1,254 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome.components import climate_ir
-from esphome.const import CONF_ID, CONF_SUPPORTS_HEAT
+import esphome.final_validate as fv
+from esphome.components import button, climate_ir, sensor
+from esphome.const import (
+    CONF_CLIMATE,
+    CONF_ID,
+    CONF_PLATFORM,
+    CONF_SENSOR,
+    CONF_SUPPORTS_HEAT,
+    CONF_UPDATE_INTERVAL,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+)
 
-AUTO_LOAD = ["climate_ir"]
+AUTO_LOAD = ["button", "climate_ir", "sensor"]
 CODEOWNERS = ["@I_am_the_Carl"]
 
 frigidaire_ns = cg.esphome_ns.namespace("frigidaire")
 FrigidareClimate = frigidaire_ns.class_("FrigidareClimate", climate_ir.ClimateIR)
+FrameStatus = frigidaire_ns.enum("FrameStatus")
+DurationStat = frigidaire_ns.enum("DurationStat")
+DisplayButton = frigidaire_ns.class_("DisplayButton", button.Button)
+
+CONF_FRAME_LOGGING = "frame_logging"
+CONF_SUPPORTS_TURBO = "supports_turbo"
+CONF_DISPLAY = "display"
+CONF_TRANSMIT_COALESCE_WINDOW = "transmit_coalesce_window"
+CONF_SUPPRESS_DUPLICATES = "suppress_duplicates"
+CONF_DUPLICATE_WINDOW = "duplicate_window"
+CONF_REFRESH_INTERVAL = "refresh_interval"
+CONF_REPEAT = "repeat"
+CONF_COUNT = "count"
+CONF_GAP = "gap"
+CONF_ADAPTIVE = "adaptive"
+CONF_ECHO_WINDOW = "echo_window"
+CONF_MIN_PUBLISH_INTERVAL = "min_publish_interval"
+CONF_PERSIST_PAYLOAD = "persist_payload"
+CONF_PERSIST_DELAY = "persist_delay"
+CONF_THERMOSTAT = "thermostat"
+CONF_HYSTERESIS = "hysteresis"
+CONF_MIN_CYCLE_TIME = "min_cycle_time"
+CONF_CAPTURE = "capture"
+CONF_CALIBRATION = "calibration"
+CONF_FRAMES = "frames"
+CONF_MARGIN = "margin"
+CONF_TRANSMIT = "transmit"
+CONF_STATISTICS = "statistics"
+CONF_FRAMES_RECEIVED = "frames_received"
+CONF_FRAMES_TRANSMITTED = "frames_transmitted"
+
+UNIT_MICROSECONDS = "µs"
+
+REPEAT_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_COUNT, default=0): cv.int_range(min=0, max=10),
+        cv.Optional(CONF_GAP): cv.positive_time_period_microseconds,
+        cv.Optional(CONF_ADAPTIVE, default=False): cv.boolean,
+    }
+)
+
+THERMOSTAT_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_HYSTERESIS, default=0.5): cv.positive_float,
+        cv.Optional(
+            CONF_MIN_CYCLE_TIME, default="5min"
+        ): cv.positive_time_period_milliseconds,
+    }
+)
 
-CONFIG_SCHEMA = climate_ir.CLIMATE_IR_WITH_RECEIVER_SCHEMA.extend(
+CALIBRATION_SCHEMA = cv.Schema(
+    {
+        # Each frame adds about a hundred bit marks, so the histograms' 16 bit bins can't overflow at this limit.
+        cv.Optional(CONF_FRAMES, default=20): cv.int_range(min=1, max=200),
+        cv.Optional(CONF_MARGIN, default="5%"): cv.percentage,
+        cv.Optional(CONF_TRANSMIT, default=False): cv.boolean,
+    }
+)
+
+FRAME_STATUSES = {
+    "frames_accepted": FrameStatus.FRAME_ACCEPTED,
+    "frames_echoed": FrameStatus.FRAME_ECHO,
+    "rejected_header": FrameStatus.FRAME_BAD_HEADER,
+    "rejected_short": FrameStatus.FRAME_TOO_SHORT,
+    "rejected_identity": FrameStatus.FRAME_BAD_IDENTITY,
+    "rejected_mode": FrameStatus.FRAME_BAD_MODE,
+    "rejected_swing": FrameStatus.FRAME_BAD_SWING,
+    "rejected_fan": FrameStatus.FRAME_BAD_FAN,
+    "rejected_checksum": FrameStatus.FRAME_BAD_CHECKSUM,
+}
+
+DURATION_STATS = {
+    "min": DurationStat.DURATION_MIN,
+    "avg": DurationStat.DURATION_AVG,
+    "max": DurationStat.DURATION_MAX,
+}
+
+COUNTER_SCHEMA = sensor.sensor_schema(
+    icon="mdi:counter",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+DURATION_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_MICROSECONDS,
+    icon="mdi:timer-outline",
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+STATISTICS_SCHEMA = cv.Schema(
+    {
+        cv.Optional(
+            CONF_UPDATE_INTERVAL, default="60s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FRAMES_RECEIVED): COUNTER_SCHEMA,
+        cv.Optional(CONF_FRAMES_TRANSMITTED): COUNTER_SCHEMA,
+        **{cv.Optional(key): COUNTER_SCHEMA for key in FRAME_STATUSES},
+        **{cv.Optional(f"decode_time_{key}"): DURATION_SCHEMA for key in DURATION_STATS},
+        **{cv.Optional(f"encode_time_{key}"): DURATION_SCHEMA for key in DURATION_STATS},
+    }
+)
+
+
+def validate_thermostat(config):
+    if CONF_THERMOSTAT in config and CONF_SENSOR not in config:
+        raise cv.Invalid(f"{CONF_THERMOSTAT} needs a {CONF_SENSOR} to read the room from")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(climate_ir.CLIMATE_IR_WITH_RECEIVER_SCHEMA.extend(
     {
         cv.GenerateID(): cv.declare_id(FrigidareClimate),
         cv.Optional(CONF_SUPPORTS_HEAT, default=False): cv.boolean,
+        cv.Optional(CONF_SUPPORTS_TURBO, default=False): cv.boolean,
+        cv.Optional(CONF_DISPLAY): button.BUTTON_SCHEMA.extend(
+            {cv.GenerateID(): cv.declare_id(DisplayButton)}
+        ),
+        cv.Optional(CONF_FRAME_LOGGING, default=True): cv.boolean,
+        cv.Optional(
+            CONF_TRANSMIT_COALESCE_WINDOW, default="250ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_SUPPRESS_DUPLICATES, default=True): cv.boolean,
+        cv.Optional(
+            CONF_DUPLICATE_WINDOW, default="10s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_REFRESH_INTERVAL): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_REPEAT): REPEAT_SCHEMA,
+        cv.Optional(
+            CONF_ECHO_WINDOW, default="500ms"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_MIN_PUBLISH_INTERVAL): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_PERSIST_PAYLOAD, default=True): cv.boolean,
+        cv.Optional(
+            CONF_PERSIST_DELAY, default="30s"
+        ): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_THERMOSTAT): THERMOSTAT_SCHEMA,
+        cv.Optional(CONF_CAPTURE, default=False): cv.boolean,
+        cv.Optional(CONF_CALIBRATION): CALIBRATION_SCHEMA,
+        cv.Optional(CONF_STATISTICS): STATISTICS_SCHEMA,
     }
-)
+), validate_thermostat)
+
+
+# These end up as defines, which apply to every Frigidaire climate on the node, not just the one that set them.
+NODE_WIDE_OPTIONS = [CONF_FRAME_LOGGING]
+
+
+def final_validate(config):
+    full_config = fv.full_config.get()
+    for other in full_config.get(CONF_CLIMATE, []):
+        if other.get(CONF_PLATFORM) != "frigidaire":
+            continue
+        for key in NODE_WIDE_OPTIONS:
+            if other[key] != config[key]:
+                raise cv.Invalid(
+                    f"{key} is compiled in and shared by every frigidaire climate, so they all need the same value "
+                    f"('{config[key]}' here, '{other[key]}' on {other[CONF_ID]})",
+                    path=[key],
+                )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = final_validate
 
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await climate_ir.register_climate_ir(var, config)
+
+    cg.add(var.set_supports_turbo(config[CONF_SUPPORTS_TURBO]))
+    if CONF_DISPLAY in config:
+        display = cg.new_Pvariable(config[CONF_DISPLAY][CONF_ID], var)
+        await button.register_button(display, config[CONF_DISPLAY])
+        cg.add(var.set_display_button(display))
+    cg.add(var.set_transmit_coalesce_window(config[CONF_TRANSMIT_COALESCE_WINDOW]))
+    cg.add(var.set_suppress_duplicates(config[CONF_SUPPRESS_DUPLICATES]))
+    cg.add(var.set_duplicate_window(config[CONF_DUPLICATE_WINDOW]))
+    if CONF_REFRESH_INTERVAL in config:
+        cg.add(var.set_refresh_interval(config[CONF_REFRESH_INTERVAL]))
+
+    if CONF_REPEAT in config:
+        repeat = config[CONF_REPEAT]
+        cg.add(var.set_repeat_count(repeat[CONF_COUNT]))
+        if CONF_GAP in repeat:
+            cg.add(var.set_repeat_gap(repeat[CONF_GAP]))
+        cg.add(var.set_repeat_adaptive(repeat[CONF_ADAPTIVE]))
+    cg.add(var.set_echo_window(config[CONF_ECHO_WINDOW]))
+    if CONF_MIN_PUBLISH_INTERVAL in config:
+        cg.add(var.set_min_publish_interval(config[CONF_MIN_PUBLISH_INTERVAL]))
+
+    if not config[CONF_FRAME_LOGGING]:
+        cg.add_define("FRIGIDAIRE_NO_FRAME_LOG")
+
+    if CONF_THERMOSTAT in config:
+        thermostat = config[CONF_THERMOSTAT]
+        cg.add(var.set_thermostat(True))
+        cg.add(var.set_thermostat_hysteresis(thermostat[CONF_HYSTERESIS]))
+        cg.add(var.set_thermostat_min_cycle(thermostat[CONF_MIN_CYCLE_TIME]))
+
+    cg.add(var.set_persist_payload(config[CONF_PERSIST_PAYLOAD]))
+    cg.add(var.set_persist_delay(config[CONF_PERSIST_DELAY]))
+
+    cg.add(var.set_capture(config[CONF_CAPTURE]))
+
+    if CONF_CALIBRATION in config:
+        calibration = config[CONF_CALIBRATION]
+        cg.add(var.set_calibration_frames(calibration[CONF_FRAMES]))
+        cg.add(var.set_calibration_margin(int(round(calibration[CONF_MARGIN] * 100))))
+        cg.add(var.set_calibration_transmit(calibration[CONF_TRANSMIT]))
+
+    if CONF_STATISTICS in config:
+        statistics = config[CONF_STATISTICS]
+        cg.add(var.set_statistics_interval(statistics[CONF_UPDATE_INTERVAL]))
+        if CONF_FRAMES_RECEIVED in statistics:
+            sens = await sensor.new_sensor(statistics[CONF_FRAMES_RECEIVED])
+            cg.add(var.set_received_sensor(sens))
+        if CONF_FRAMES_TRANSMITTED in statistics:
+            sens = await sensor.new_sensor(statistics[CONF_FRAMES_TRANSMITTED])
+            cg.add(var.set_transmitted_sensor(sens))
+        for key, status in FRAME_STATUSES.items():
+            if key in statistics:
+                sens = await sensor.new_sensor(statistics[key])
+                cg.add(var.set_frame_status_sensor(status, sens))
+        for key, stat in DURATION_STATS.items():
+            if f"decode_time_{key}" in statistics:
+                sens = await sensor.new_sensor(statistics[f"decode_time_{key}"])
+                cg.add(var.set_decode_time_sensor(stat, sens))
+            if f"encode_time_{key}" in statistics:
+                sens = await sensor.new_sensor(statistics[f"encode_time_{key}"])
+                cg.add(var.set_encode_time_sensor(stat, sens))
@@ -2,37 +2,421 @@
 #include "frigidaire.h"
 #include <cstdint>
 #include <array>
+#include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <cmath>
 #include <optional>
+#include <utility>
 
 namespace esphome {
     namespace frigidaire {
         static const char* const TAG = "frigidaire.climate";
 
-        const uint16_t HEADER_MARK = 8968;
-        const uint16_t HEADER_SPACE = 4425;
+        constexpr NibbleTimings encodeNibble(uint8_t nibble, int32_t bitMark, int32_t oneSpace, int32_t zeroSpace) {
+            NibbleTimings timings {};
+            for (uint8_t bit = 0; bit < 4; bit += 1) {
+                timings[2 * bit] = bitMark;
+                timings[2 * bit + 1] = -(((nibble >> bit) & 0x01) != 0x00 ? oneSpace : zeroSpace);
+            }
+            return timings;
+        }
+
+        // Works at compile time for the nominal timings, and at runtime for calibrated ones.
+        constexpr TransmitTimings makeTransmitTimings(int32_t headerMark, int32_t headerSpace, int32_t bitMark, int32_t oneSpace, int32_t zeroSpace, int32_t gapSpace) {
+            TransmitTimings timings {headerMark, headerSpace, bitMark, gapSpace, {}};
+            for (uint8_t nibble = 0; nibble < 16; nibble += 1) {
+                timings.nibbles[nibble] = encodeNibble(nibble, bitMark, oneSpace, zeroSpace);
+            }
+            return timings;
+        }
+
+        template<typename Protocol>
+        constexpr TransmitTimings NOMINAL_TRANSMIT_TIMINGS = makeTransmitTimings(
+            Protocol::HEADER_MARK, Protocol::HEADER_SPACE, Protocol::BIT_MARK, Protocol::ONE_SPACE, Protocol::ZERO_SPACE, Protocol::GAP_SPACE);
 
-        const uint16_t BIT_MARK = 600;
-        const uint16_t ONE_SPACE = 1650;
-        const uint16_t ZERO_SPACE = 500;
-        const uint16_t GAP_SPACE = HEADER_MARK;
+        static_assert(NOMINAL_TRANSMIT_TIMINGS<FrigidaireProtocol>.nibbles[0x5][0] == 600 && NOMINAL_TRANSMIT_TIMINGS<FrigidaireProtocol>.nibbles[0x5][1] == -1650, "Bit 0 of 0x5 should be a one.");
+        static_assert(NOMINAL_TRANSMIT_TIMINGS<FrigidaireProtocol>.nibbles[0x5][3] == -500 && NOMINAL_TRANSMIT_TIMINGS<FrigidaireProtocol>.nibbles[0x5][7] == -500, "Bits 1 and 3 of 0x5 should be zeros.");
 
-        const size_t messageLength = sizeof(Payload);
+        // Lays out the timings of a whole frame, header to gap.
+        void encodeFrame(const Frame & raw, const TransmitTimings & pulses, int32_t * timings) {
+            // Grab their attention with a precicely timed flash, then pause.
+            timings[0] = pulses.headerMark;
+            timings[1] = -pulses.headerSpace;
+            timings += 2;
 
-        uint8_t calculateChecksum(const std::array<uint8_t, messageLength> & raw) {
-            uint8_t calculatedChecksum = 0x0;
-            for (std::array<uint8_t, messageLength>::const_iterator byte_iterator = raw.cbegin(), end = raw.cend() - 1; byte_iterator != end; byte_iterator += 1) {
-                calculatedChecksum += *byte_iterator;
+            for (const uint8_t & byte : raw) {
+                std::memcpy(timings, pulses.nibbles[byte & 0x0F].data(), sizeof(NibbleTimings));
+                std::memcpy(timings + 8, pulses.nibbles[byte >> 4].data(), sizeof(NibbleTimings));
+                timings += 16;
             }
 
-            return calculatedChecksum;
+            // We need that extra bit mark so the receiver recognizes the end of a transmission.
+            timings[0] = pulses.bitMark;
+            timings[1] = -pulses.gapSpace;
         }
+
+// Frame dumps only exist at VERBOSE, and `frame_logging: false` strips them even then.
+#if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERBOSE && !defined(FRIGIDAIRE_NO_FRAME_LOG)
+#define FRIGIDAIRE_FRAME_LOG
+#endif
+
+        // Potentally useful for debug and troubleshooting.
+        // Formats into the stack so logging a frame never touches the heap.
+        void logFrame(const char * direction, const Frame & raw) {
+#ifdef FRIGIDAIRE_FRAME_LOG
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+
+            // Two digits and a separator per byte, plus the terminator.
+            char stringified[3 * ActiveProtocol::FRAME_LENGTH + 1];
+            char * cursor = stringified;
+            for (uint8_t byte : raw) {
+                *cursor++ = HEX_DIGITS[byte >> 4];
+                *cursor++ = HEX_DIGITS[byte & 0x0F];
+                *cursor++ = '|';
+            }
+            *cursor = '\0';
+
+            ESP_LOGV(TAG, "RAW %s: %s", direction, stringified);
+#endif
+        }
+
+        // remote_receiver's default tolerance, in percent.
+        const uint8_t DECODE_TOLERANCE = 25;
+
+        template<typename Protocol>
+        constexpr PulseWindows NOMINAL_WINDOWS = {{
+            PulseWindow::around(Protocol::HEADER_MARK, DECODE_TOLERANCE),
+            PulseWindow::around(Protocol::HEADER_SPACE, DECODE_TOLERANCE),
+            PulseWindow::around(Protocol::BIT_MARK, DECODE_TOLERANCE),
+            PulseWindow::around(Protocol::ONE_SPACE, DECODE_TOLERANCE),
+            PulseWindow::around(Protocol::ZERO_SPACE, DECODE_TOLERANCE)
+        }};
+
+        // Zero and one spaces must not overlap or bits become ambiguous.
+        constexpr bool bitsAreDistinct(const PulseWindows & windows) {
+            return windows[PULSE_ZERO_SPACE].max < windows[PULSE_ONE_SPACE].min;
+        }
+
+        static_assert(bitsAreDistinct(NOMINAL_WINDOWS<ActiveProtocol>), "Nominal zero and one spaces overlap.");
+
+        FrameStatus decodeFrame(const std::vector<int32_t> & timings, const PulseWindows & windows, Frame & raw) {
+            const int32_t * pulse = timings.data();
+
+            if (timings.size() < 2 || !windows[PULSE_HEADER_MARK].matchesMark(pulse[0]) || !windows[PULSE_HEADER_SPACE].matchesSpace(pulse[1])) {
+                return FRAME_BAD_HEADER;
+            }
+            pulse += 2;
+
+            // Anything shorter than a whole frame can be thrown out before looking at a single bit.
+            if (timings.size() < ActiveProtocol::FRAME_TIMINGS - 1) {
+                return FRAME_TOO_SHORT;
+            }
+
+            for (uint8_t & byte : raw) {
+                byte = 0;
+                for (uint8_t bit = 0; bit < 8; bit += 1) {
+                    if (!windows[PULSE_BIT_MARK].matchesMark(pulse[0])) {
+                        return FRAME_TOO_SHORT;
+                    }
+
+                    if (windows[PULSE_ONE_SPACE].matchesSpace(pulse[1])) {
+                        byte |= 1 << bit;
+                    } else if (!windows[PULSE_ZERO_SPACE].matchesSpace(pulse[1])) {
+                        return FRAME_TOO_SHORT;
+                    }
+
+                    pulse += 2;
+                }
+            }
+
+            // The size check above only guarantees something follows the last bit. It has to be a bit mark as well,
+            // or this is a longer frame that happens to start like ours, or a burst with a glitch where the trailer should be.
+            if (!windows[PULSE_BIT_MARK].matchesMark(pulse[0])) {
+                return FRAME_TOO_SHORT;
+            }
+
+            return FRAME_ACCEPTED;
+        }
+
+        const char * frameStatusName(FrameStatus status) {
+            switch (status) {
+                case FRAME_ACCEPTED: return "accepted";
+                case FRAME_ECHO: return "echo";
+                case FRAME_BAD_HEADER: return "header";
+                case FRAME_TOO_SHORT: return "too short";
+                case FRAME_BAD_IDENTITY: return "identity";
+                case FRAME_BAD_MODE: return "mode";
+                case FRAME_BAD_SWING: return "swing";
+                case FRAME_BAD_FAN: return "fan speed";
+                case FRAME_BAD_CHECKSUM: return "checksum";
+                default: return "unknown";
+            }
+        }
+
+        // Frames captured from the real remote. Bytes 2 and 11 aren't understood yet, which is why they're not zero.
+        constexpr Frame AUTO_FRAME = {0xc3, 0x4f, 0xe0, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x05, 0xb7};
+        constexpr Frame COOL_FRAME = {0xc3, 0x67, 0xe0, 0x00, 0xa0, 0x00, 0x20, 0x00, 0x00, 0x20, 0x00, 0x05, 0xef};
+
+        static_assert(ActiveProtocol::checksum(AUTO_FRAME) == AUTO_FRAME.back() && ActiveProtocol::checksum(COOL_FRAME) == COOL_FRAME.back(), "Checksum should match the remote.");
+
+        static_assert(Payload::unpack(AUTO_FRAME).getIdentity() == 0xc3, "Identity is byte 0.");
+        static_assert(Payload::unpack(AUTO_FRAME).getMode() == Mode::MODE_AUTO && Payload::unpack(COOL_FRAME).getMode() == Mode::COOL, "Mode is the top 3 bits of byte 6.");
+        static_assert(Payload::unpack(AUTO_FRAME).getTempratureC() == 17 && Payload::unpack(COOL_FRAME).getTempratureC() == 20, "Temprature is the top 5 bits of byte 1.");
+        static_assert(Payload::unpack(AUTO_FRAME).getSwingMode() == SwingMode::SWING_OFF, "Swing is the low 3 bits of byte 1.");
+        static_assert(Payload::unpack(AUTO_FRAME).getFanSpeed() == FanSpeed::FAN_AUTO, "Fan speed is the top 4 bits of byte 4.");
+        static_assert(Payload::unpack(AUTO_FRAME).isPowered(), "Power is bit 5 of byte 9.");
+        static_assert(!Payload::unpack(AUTO_FRAME).isTurbo(), "Turbo is bit 6 of byte 5.");
+        static_assert(!Payload::unpack(AUTO_FRAME).isDisplayToggle(), "The remote's usual byte 11 leaves the display alone.");
+
+        // Setting every field we know about on top of the unknown bytes has to give the remote's frame back, bit for bit.
+        constexpr bool packsLikeTheRemote() {
+            Frame unknown = AUTO_FRAME;
+            unknown[1] = 0;
+            unknown[4] = 0;
+            unknown[6] = 0;
+            unknown[9] = 0;
+
+            Payload payload = Payload::unpack(unknown);
+            payload.setPowered(true);
+            payload.setMode(Mode::COOL);
+            payload.setTempratureC(20);
+            payload.setSwingMode(SwingMode::SWING_OFF);
+            payload.setFanSpeed(FanSpeed::FAN_AUTO);
+
+            Frame raw = payload.pack();
+            raw.back() = ActiveProtocol::checksum(raw);
+
+            // std::array's == isn't constexpr until C++20.
+            for (size_t byte = 0; byte < raw.size(); byte += 1) {
+                if (raw[byte] != COOL_FRAME[byte]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(packsLikeTheRemote(), "Packing should reproduce a frame from the remote.");
+
+        // Whatever the remote left in the bits we don't know about has to survive us changing the ones we do.
+        constexpr bool keepsUnknownBits() {
+            Frame ones {};
+            for (uint8_t & byte : ones) {
+                byte = 0xFF;
+            }
+
+            Payload payload = Payload::unpack(ones);
+            payload.setTurbo(false);
+            payload.setPowered(false);
+            payload.setDisplayToggle(false);
+
+            const Frame raw = payload.pack();
+            for (size_t byte = 0; byte < raw.size(); byte += 1) {
+                const uint8_t cleared = (byte == Payload::TURBO.byte ? Payload::TURBO.mask() : 0) | (byte == Payload::POWER.byte ? Payload::POWER.mask() : 0) |
+                    (byte == Payload::DISPLAY.byte ? 0x10 : 0);
+                if (raw[byte] != static_cast<uint8_t>(0xFF & ~cleared)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static_assert(keepsUnknownBits(), "Setting a field should only ever touch that field's bits.");
+
+        // Every valid combination of fields has to come back out the way it went in, without disturbing its neighbours.
+        constexpr bool roundTripsAllFields() {
+            const Mode modes[] = {Mode::MODE_AUTO, Mode::COOL, Mode::DRY, Mode::FAN};
+            const SwingMode swings[] = {SwingMode::SWING_ON, SwingMode::SWING_OFF};
+            const FanSpeed fans[] = {FanSpeed::FAN_AUTO, FanSpeed::FAN_HIGH, FanSpeed::FAN_MID, FanSpeed::FAN_LOW};
+
+            for (bool powered : {false, true}) {
+                for (Mode mode : modes) {
+                    for (SwingMode swing : swings) {
+                        for (FanSpeed fan : fans) {
+                            for (uint8_t temprature = FRIGIDAIRE_TEMP_C_MIN; temprature <= FRIGIDAIRE_TEMP_C_MAX; temprature += 1) {
+                                Payload payload;
+                                payload.setPowered(powered);
+                                payload.setMode(mode);
+                                payload.setSwingMode(swing);
+                                payload.setFanSpeed(fan);
+                                payload.setTempratureC(temprature);
+
+                                const Payload unpacked = Payload::unpack(payload.pack());
+                                if (unpacked.isPowered() != powered || unpacked.getMode() != mode || unpacked.getSwingMode() != swing ||
+                                    unpacked.getFanSpeed() != fan || unpacked.getTempratureC() != temprature || unpacked.getIdentity() != ActiveProtocol::IDENTITY) {
+                                    return false;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(roundTripsAllFields(), "Every valid field combination should survive a pack and unpack.");
         
+        void FrigidareClimate::setup() {
+            // Before anything else gets the chance to transmit.
+            if (this->persistPayload) {
+                this->restorePayload();
+            }
+
+            climate_ir::ClimateIR::setup();
+
+            if (this->refreshInterval != 0) {
+                this->set_interval("refresh", this->refreshInterval, [this]() {
+                    // Nothing to refresh until we've said something, or if the remote has changed things since.
+                    if (this->lastSentValid) {
+                        ESP_LOGD(TAG, "Refreshing last frame.");
+                        this->sendFrame(this->lastSent);
+                    }
+                });
+            }
+
+            if (this->calibrationFrames != 0) {
+                this->startCalibration();
+            }
+
+            if (this->thermostat) {
+                if (this->sensor_ != nullptr) {
+                    // ClimateIR registered first, so current_temperature is already up to date by the time this runs.
+                    this->sensor_->add_on_state_callback([this](float state) {
+                        if (this->updateThermostat()) {
+                            this->transmit_state();
+                            this->publish_state();
+                        }
+                    });
+                } else {
+                    ESP_LOGW(TAG, "Thermostat needs a sensor, leaving it to the unit.");
+                    this->thermostat = false;
+                }
+            }
+
+            if (this->hasStatisticsSensors()) {
+                this->set_interval("statistics", this->statisticsInterval, [this]() {
+                    this->publishStatistics();
+                });
+            }
+        }
+
+        void FrigidareClimate::restorePayload() {
+            this->payloadPreference = global_preferences->make_preference<Frame>(this->get_object_id_hash() ^ fnv1_hash("frigidaire_payload"));
+
+            Frame saved;
+            if (!this->payloadPreference.load(&saved)) {
+                ESP_LOGD(TAG, "No saved payload, starting from defaults.");
+                return;
+            }
+
+            // Flash gets corrupted and layouts change, so hold it to the same standard as a frame off the air.
+            const Payload payload = Payload::unpack(saved);
+            if (payload.getIdentity() != ActiveProtocol::IDENTITY || ActiveProtocol::checksum(saved) != payload.getChecksum() ||
+                payload.getMode() == Mode::MODE_INVALID || payload.getSwingMode() == SwingMode::SWING_INVALID || payload.getFanSpeed() == FanSpeed::FAN_INVALID) {
+                ESP_LOGW(TAG, "Saved payload is invalid, starting from defaults.");
+                return;
+            }
+
+            this->payload = payload;
+            this->persisted = saved;
+            logFrame("restored", saved);
+            ESP_LOGI(TAG, "Restored last payload.");
+        }
+
+        void FrigidareClimate::schedulePersist() {
+            // The first change starts the clock and the rest ride along, so even a steady stream of changes
+            // only writes once per delay. Whatever the payload is when it fires is what gets saved.
+            if (!this->persistPayload || this->persistPending) {
+                return;
+            }
+
+            this->persistPending = true;
+            this->set_timeout("persist", this->persistDelay, [this]() {
+                this->persistPending = false;
+
+                Frame raw = this->payload.pack();
+                raw.back() = ActiveProtocol::checksum(raw);
+                if (raw == this->persisted) {
+                    return;
+                }
+
+                if (this->payloadPreference.save(&raw)) {
+                    this->persisted = raw;
+                    ESP_LOGD(TAG, "Saved payload.");
+                } else {
+                    ESP_LOGW(TAG, "Couldn't save payload.");
+                }
+            });
+        }
+
+        void FrigidareClimate::publishReceivedState() {
+            const uint32_t now = millis();
+            const uint32_t sinceLast = now - this->lastPublishAt;
+
+            if (this->minPublishInterval == 0 || sinceLast >= this->minPublishInterval) {
+                this->cancel_timeout("publish");
+                this->lastPublishAt = now;
+                this->publish_state();
+            } else {
+                // Too soon. Publish whatever the state is once the interval is up, so the last change still gets out.
+                this->set_timeout("publish", this->minPublishInterval - sinceLast, [this]() {
+                    this->lastPublishAt = millis();
+                    this->publish_state();
+                });
+            }
+        }
+
+        bool FrigidareClimate::hasStatisticsSensors() const {
+            auto configured = [](sensor::Sensor * sensor) { return sensor != nullptr; };
+            return this->receivedSensor != nullptr || this->transmittedSensor != nullptr ||
+                std::any_of(this->frameStatusSensors.begin(), this->frameStatusSensors.end(), configured) ||
+                std::any_of(this->decodeTimeSensors.begin(), this->decodeTimeSensors.end(), configured) ||
+                std::any_of(this->encodeTimeSensors.begin(), this->encodeTimeSensors.end(), configured);
+        }
+
+        void FrigidareClimate::publishStatistics() {
+            if (this->receivedSensor != nullptr) {
+                this->receivedSensor->publish_state(this->framesReceived);
+            }
+            if (this->transmittedSensor != nullptr) {
+                this->transmittedSensor->publish_state(this->framesTransmitted);
+            }
+            for (size_t status = 0; status < FRAME_STATUS_COUNT; status += 1) {
+                if (this->frameStatusSensors[status] != nullptr) {
+                    this->frameStatusSensors[status]->publish_state(this->frameStatusCounts[status]);
+                }
+            }
+
+            // Durations cover one interval each, so a slow spell doesn't get averaged away over the uptime.
+            for (size_t stat = 0; stat < DURATION_STAT_COUNT; stat += 1) {
+                if (this->decodeTimeSensors[stat] != nullptr && !this->decodeTimes.empty()) {
+                    this->decodeTimeSensors[stat]->publish_state(this->decodeTimes.get(static_cast<DurationStat>(stat)));
+                }
+                if (this->encodeTimeSensors[stat] != nullptr && !this->encodeTimes.empty()) {
+                    this->encodeTimeSensors[stat]->publish_state(this->encodeTimes.get(static_cast<DurationStat>(stat)));
+                }
+            }
+            this->decodeTimes.reset();
+            this->encodeTimes.reset();
+        }
+
         climate::ClimateTraits FrigidareClimate::traits() {
+            // The API and web server ask for these all the time, and they never change, so only build them once.
+            // The first request can come from the climate's own restore during setup(), hence not building them there.
+            if (!this->traitsBuilt) {
+                this->cachedTraits = this->buildTraits();
+                this->traitsBuilt = true;
+            }
+
+            return this->cachedTraits;
+        }
+
+        climate::ClimateTraits FrigidareClimate::buildTraits() const {
             // The capabilities of the climate device
             auto traits = climate::ClimateTraits();
             traits.set_supports_current_temperature(true);
+            traits.set_supports_action(this->thermostat);
             traits.set_supported_modes({
                 climate::CLIMATE_MODE_OFF,
                 climate::CLIMATE_MODE_COOL,
@@ -51,6 +435,13 @@ namespace esphome {
                 climate::ClimateSwingMode::CLIMATE_SWING_VERTICAL
             });
 
+            if (this->supportsTurbo) {
+                traits.set_supported_presets({
+                    climate::ClimatePreset::CLIMATE_PRESET_NONE,
+                    climate::ClimatePreset::CLIMATE_PRESET_BOOST
+                });
+            }
+
             traits.set_visual_min_temperature(16.0f);
             traits.set_visual_max_temperature(32.0f);
             traits.set_visual_temperature_step(1.0f);
@@ -58,6 +449,129 @@ namespace esphome {
             return traits;
         }
 
+        // A pending transmit is pushed back by every new change, but never more than this many windows in total.
+        // That way someone who never lets go of the slider still gets through.
+        const uint32_t COALESCE_MAX_WINDOWS = 4;
+
+        void FrigidareClimate::control(const climate::ClimateCall &call) {
+            // Same as ClimateIR, except the transmit may be held back.
+            if (call.get_mode().has_value()) {
+                if (this->thermostat && *call.get_mode() == climate::CLIMATE_MODE_COOL && this->mode != climate::CLIMATE_MODE_COOL) {
+                    // Coming from another mode, nothing has been cycling, so there's nothing to protect yet.
+                    this->startThermostatCycle(std::isnan(this->current_temperature) || this->current_temperature > this->target_temperature - this->thermostatHysteresis);
+                }
+                this->mode = *call.get_mode();
+            }
+            if (call.get_target_temperature().has_value()) {
+                this->target_temperature = *call.get_target_temperature();
+            }
+            if (call.get_fan_mode().has_value()) {
+                this->fan_mode = *call.get_fan_mode();
+            }
+            if (call.get_swing_mode().has_value()) {
+                this->swing_mode = *call.get_swing_mode();
+            }
+            if (call.get_preset().has_value()) {
+                this->preset = *call.get_preset();
+            }
+
+            // A new target can put us outside the band straight away.
+            if (this->thermostat) {
+                this->updateThermostat();
+                this->updateAction();
+            }
+
+            if (this->coalesceWindow == 0) {
+                this->transmit_state();
+            } else {
+                this->scheduleTransmit();
+            }
+
+            this->publish_state();
+        }
+
+        void FrigidareClimate::startThermostatCycle(bool cooling) {
+            this->thermostatCooling = cooling;
+            this->thermostatCycleStart = millis();
+            this->cancel_timeout("thermostat");
+        }
+
+        // Decides whether the unit should be cooling. Returns true if that changed and needs transmitting.
+        bool FrigidareClimate::updateThermostat() {
+            if (!this->thermostat || this->mode != climate::CLIMATE_MODE_COOL || std::isnan(this->current_temperature)) {
+                return false;
+            }
+
+            bool cooling = this->thermostatCooling;
+            if (this->current_temperature >= this->target_temperature + this->thermostatHysteresis) {
+                cooling = true;
+            } else if (this->current_temperature <= this->target_temperature - this->thermostatHysteresis) {
+                cooling = false;
+            }
+
+            if (cooling == this->thermostatCooling) {
+                return false;
+            }
+
+            // Short cycling is hard on the compressor, and every switch costs a frame.
+            const uint32_t elapsed = millis() - this->thermostatCycleStart;
+            if (elapsed < this->thermostatMinCycle) {
+                ESP_LOGV(TAG, "Thermostat wants to switch, holding for another %ums.", this->thermostatMinCycle - elapsed);
+                // The sensor may not report again for a while, so look again once the cycle is up.
+                this->set_timeout("thermostat", this->thermostatMinCycle - elapsed, [this]() {
+                    if (this->updateThermostat()) {
+                        this->transmit_state();
+                        this->publish_state();
+                    }
+                });
+                return false;
+            }
+
+            ESP_LOGD(TAG, "Thermostat %s at %.1f for a target of %.1f.", cooling ? "cooling" : "idling", this->current_temperature, this->target_temperature);
+            this->startThermostatCycle(cooling);
+            this->updateAction();
+            return true;
+        }
+
+        void FrigidareClimate::updateAction() {
+            switch (this->mode) {
+                case climate::CLIMATE_MODE_OFF:
+                    this->action = climate::CLIMATE_ACTION_OFF;
+                    break;
+                case climate::CLIMATE_MODE_COOL:
+                    this->action = this->thermostatCooling ? climate::CLIMATE_ACTION_COOLING : climate::CLIMATE_ACTION_IDLE;
+                    break;
+                case climate::CLIMATE_MODE_FAN_ONLY:
+                    this->action = climate::CLIMATE_ACTION_FAN;
+                    break;
+                case climate::CLIMATE_MODE_DRY:
+                    this->action = climate::CLIMATE_ACTION_DRYING;
+                    break;
+                default:
+                    // Auto is up to the unit, and we can't see what it decided.
+                    this->action = climate::CLIMATE_ACTION_IDLE;
+                    break;
+            }
+        }
+
+        void FrigidareClimate::scheduleTransmit() {
+            const uint32_t now = millis();
+            if (!this->transmitPending) {
+                this->transmitPending = true;
+                this->firstPendingChange = now;
+            }
+
+            // transmit_state() reads whatever the state is when it fires, so only the last change gets sent.
+            const uint32_t waited = now - this->firstPendingChange;
+            const uint32_t limit = COALESCE_MAX_WINDOWS * this->coalesceWindow;
+            const uint32_t delay = waited >= limit ? 0 : std::min(this->coalesceWindow, limit - waited);
+
+            this->set_timeout("transmit", delay, [this]() {
+                this->transmitPending = false;
+                this->transmit_state();
+            });
+        }
+
         void FrigidareClimate::transmit_state() {
             switch (this->mode) {
                 case climate::CLIMATE_MODE_OFF:
@@ -70,7 +584,8 @@ namespace esphome {
                     break;
                 case climate::CLIMATE_MODE_COOL:
                     this->payload.setPowered(true); // You have to turn it on as well.
-                    this->payload.setMode(Mode::COOL);
+                    // While the thermostat has it idling, the fan keeps the air moving past the sensor.
+                    this->payload.setMode(this->thermostat && !this->thermostatCooling ? Mode::FAN : Mode::COOL);
                     break;
                 case climate::CLIMATE_MODE_DRY:
                     this->payload.setPowered(true); // You have to turn it on as well.
@@ -100,7 +615,7 @@ namespace esphome {
                         this->payload.setFanSpeed(FanSpeed::FAN_LOW);
                         break;
                     default:
-                        ESP_LOGW(TAG, "Invalid fan mode requested: %02x", this->fan_mode);
+                        ESP_LOGW(TAG, "Invalid fan mode requested: %02x", *this->fan_mode);
                         break;
                 }
             } else {
@@ -121,302 +636,550 @@ namespace esphome {
 
             payload.setTempratureC(this->target_temperature);
 
+            if (this->supportsTurbo) {
+                this->payload.setTurbo(this->preset.has_value() && *this->preset == climate::CLIMATE_PRESET_BOOST);
+            }
+
             // Convert the payload to a buffer.
-            std::array<uint8_t, messageLength> raw;
-            std::memcpy(&raw.front(), &this->payload, raw.size());
+            Frame raw = this->payload.pack();
 
             // Calculate the checksum.
-            uint8_t calculatedChecksum = calculateChecksum(raw);
+            uint8_t calculatedChecksum = ActiveProtocol::checksum(raw);
             raw.back() = calculatedChecksum;
 
-            // TODO this is hard coded for testing.
-            // raw = {0xc3, 0x4f, 0xe0, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x05, 0xb7}; // Auto mode.
-            // raw = { 0xc3, 0x67, 0xe0, 0x00, 0xa0, 0x00, 0x20, 0x00, 0x00, 0x20, 0x00, 0x05, 0xef }; // Cool mode.
+            if (this->displayTogglePending) {
+                this->displayTogglePending = false;
+                this->sendDisplayToggle(raw);
+                this->schedulePersist();
+                return;
+            }
 
-            // Potentally useful for debug and troubleshooting.
-            std::string stringified;
-            for (uint8_t byte : raw) {
-                stringified += format_hex(byte);
-                stringified += "|";
+            logFrame("TX", raw);
+
+            // Automations love to reassert state that hasn't changed. The checksum rules most frames out without the full compare.
+            // Past the window it goes out anyway, so asking again still gets through to a unit that missed the first one.
+            if (this->suppressDuplicates && this->lastSentValid && millis() - this->lastTransmitAt < this->duplicateWindow &&
+                this->lastSent.back() == raw.back() && this->lastSent == raw) {
+                ESP_LOGD(TAG, "Frame unchanged, not sending.");
+                return;
             }
-            ESP_LOGD(TAG, "RAW: %s", stringified.c_str());
 
-            auto transmit = this->transmitter_->transmit();
-            remote_base::RemoteTransmitData *data = transmit.get_data();
+            this->sendFrame(raw);
+            this->schedulePersist();
+        }
 
-            data->reset();
-            data->set_carrier_frequency(38000);
-            data->reserve(8 * messageLength + 3);
+        void FrigidareClimate::sendFrame(const Frame & raw) {
+            const uint32_t start = micros();
 
-            // Grab their attention with a precicely timed flash, then pause.
-            data->item(HEADER_MARK, HEADER_SPACE);
+            // The buffer is sized once and reused, so there's no allocation per frame.
+            this->timings.resize(ActiveProtocol::FRAME_TIMINGS);
+            encodeFrame(raw, this->calibratedTransmit ? *this->calibratedTransmit : NOMINAL_TRANSMIT_TIMINGS<ActiveProtocol>, this->timings.data());
 
-            // Encode the bits.
-            for (const uint8_t & byte : raw) {
-                ESP_LOGD(TAG, "BYTE: %02x", byte);
-                for (uint8_t bit = 0; bit < 8; bit += 1) {
-                    if (((byte >> bit) & 0x01) != 0x00) {
-                        data->item(BIT_MARK, ONE_SPACE);
-                    } else {
-                        data->item(BIT_MARK, ZERO_SPACE);
-                    }
-                }
+            this->encodeTimes.add(micros() - start);
+
+            this->lastSent = raw;
+            this->lastSentValid = true;
+
+            if (this->repeatAdaptive && this->repeatCount > 0) {
+                // One at a time, so we get a chance to hear ourselves between them.
+                this->performTransmit(1);
+                this->repeatsRemaining = this->repeatCount;
+                this->scheduleRepeat();
+            } else {
+                // A newer frame replaces whatever repeats were still pending.
+                this->repeatsRemaining = 0;
+                this->cancel_timeout("repeat");
+                this->performTransmit(1 + this->repeatCount);
             }
+        }
 
-            // We need that extra bit mark so the receiver recognizes the end of a transmission.
-            data->item(BIT_MARK, GAP_SPACE);
+        void FrigidareClimate::toggleDisplay() {
+            // Whatever is still being coalesced goes out with it.
+            this->cancel_timeout("transmit");
+            this->transmitPending = false;
 
-            // And transmit!
-            // for (int i = 0; i < 5; i += 1) {
-                transmit.perform();
-            // }
+            this->displayTogglePending = true;
+            this->transmit_state();
         }
 
-        bool FrigidareClimate::on_receive(remote_base::RemoteReceiveData data) {
-            if (data.expect_item(HEADER_MARK, HEADER_SPACE)) {
-                // That timing is right to be our controller.
-                // That's not a guarentee it's our controller though.
-
-                std::array<uint8_t, messageLength> raw;
-                raw.fill(0); // Clear all the bits. It's safer this way.
-
-                // Read the bits.
-                for (uint8_t & byte : raw) {
-                    for (uint8_t bit = 0; bit < 8; bit += 1) {
-                        if (data.expect_item(BIT_MARK, ZERO_SPACE)) {
-                            // It's a zero.
-                            // We don't actually need to clear the bit since I cleared all of them earlier.
-                            // byte &= ~(1 << bit);
-                        } else if (data.expect_item(BIT_MARK, ONE_SPACE)) {
-                            // It's a one.
-                            byte |= 1 << bit;
-                        } else {
-                            // It's... not meant for us I guess?
-                            // Give up on this one.
-                            ESP_LOGW(TAG, "MESSAGE TOO SHORT.");
-                            return false;
-                        }
-                    }
-                    ESP_LOGD(TAG, "BYTE: %02x", byte);
-                }
+        void FrigidareClimate::sendDisplayToggle(const Frame & state) {
+            Payload toggle = Payload::unpack(state);
+            toggle.setDisplayToggle(true);
+            Frame raw = toggle.pack();
+            raw.back() = ActiveProtocol::checksum(raw);
 
-                // Potentally useful for debug and troubleshooting.
-                std::string stringified;
-                for (uint8_t byte : raw) {
-                    stringified += format_hex(byte);
-                    stringified += "|";
-                }
-                ESP_LOGD(TAG, "RAW: %s", stringified.c_str());
-
-                // Copy it into a struct.
-                Payload payload;
-                std::memcpy(&payload, &raw.front(), raw.size());
-
-                if (payload.getIdentity() == 0xc3) {
-                    // Okay, so we had enough bits worth of data.
-                    // Now we have to validate that data.
-
-                    // Validate the mode.
-                    if (payload.getMode() != Mode::MODE_INVALID) {
-                        // Validate the swing.
-                        if (payload.getSwingMode() != SwingMode::SWING_INVALID) {
-                            // Validate the fan speed.
-                            if (payload.getFanSpeed() != FanSpeed::FAN_INVALID) {
-                                // Validate the checksum.
-                                uint8_t calculatedChecksum = calculateChecksum(raw);
-
-                                if (calculatedChecksum == payload.getChecksum()) {
-                                    ESP_LOGD(TAG, "Checksum passed.");
-
-                                    // Everything is valid!
-                                    // Apply the state!
-
-                                    // Powered is special since the controller doesn't consider it a mode.
-                                    if (payload.isPowered()) {
-                                        // It's on, so we need to get the mode.
-                                        switch (payload.getMode()) {
-                                            case Mode::MODE_AUTO:
-                                                this->mode = climate::CLIMATE_MODE_AUTO;
-                                                break;
-                                            case Mode::COOL:
-                                                this->mode = climate::CLIMATE_MODE_COOL;
-                                                break;
-                                            case Mode::DRY:
-                                                this->mode = climate::CLIMATE_MODE_DRY;
-                                                break;
-                                            case Mode::FAN:
-                                                this->mode = climate::CLIMATE_MODE_FAN_ONLY;
-                                                break;
-                                            default:
-                                                // Should be impossible at this point.
-                                                ESP_LOGW(TAG, "Impossible mode: %02x", payload.getMode());
-                                                break;
-                                        }
-                                    } else {
-                                        // It's off.
-                                        this->mode = climate::CLIMATE_MODE_OFF;
+            logFrame("TX", raw);
+            this->lastDisplayToggle = raw;
 
-                                        // When the controller turns us off, it sends an invalid temprature, so just reset to the previous temprature setting.
-                                        payload.setTempratureC(this->target_temperature);
-                                    }
+            const uint32_t start = micros();
+            this->timings.resize(ActiveProtocol::FRAME_TIMINGS);
+            encodeFrame(raw, this->calibratedTransmit ? *this->calibratedTransmit : NOMINAL_TRANSMIT_TIMINGS<ActiveProtocol>, this->timings.data());
+            this->encodeTimes.add(micros() - start);
 
-                                    switch (payload.getFanSpeed()) {
-                                        case FanSpeed::FAN_AUTO:
-                                            this->fan_mode = climate::CLIMATE_FAN_AUTO;
-                                            break;
-                                        case FanSpeed::FAN_HIGH:
-                                            this->fan_mode = climate::CLIMATE_FAN_HIGH;
-                                            break;
-                                        case FanSpeed::FAN_MID:
-                                            this->fan_mode = climate::CLIMATE_FAN_MEDIUM;
-                                            break;
-                                        case FanSpeed::FAN_LOW:
-                                            this->fan_mode = climate::CLIMATE_FAN_LOW;
-                                            break;
-                                        default:
-                                            // Should be impossible at this point.
-                                            ESP_LOGW(TAG, "Impossible fan speed: %02x", payload.getFanSpeed());
-                                            break;
-                                    }
+            // The display flips on every copy the unit hears, so this goes out exactly once, whatever the repeat settings.
+            this->repeatsRemaining = 0;
+            this->cancel_timeout("repeat");
+            this->performTransmit(1);
 
-                                    switch (payload.getSwingMode()) {
-                                        case SwingMode::SWING_ON:
-                                            this->swing_mode = climate::CLIMATE_SWING_VERTICAL;
-                                            break;
-                                        case SwingMode::SWING_OFF:
-                                            this->swing_mode = climate::CLIMATE_SWING_OFF;
-                                            break;
-                                        default:
-                                            // SHould be impossible at this point.
-                                            ESP_LOGW(TAG, "Impossible swing mode: %02x", payload.getSwingMode());
-                                            break;
-                                    }
+            // The unit is left in the state the toggle carried, and that's what refreshes, duplicates and echoes are held against.
+            this->lastSent = state;
+            this->lastSentValid = true;
+        }
 
-                                    // Only change the temprature if we're in auto or cooling mode.
-                                    switch (payload.getMode()) {
-                                        case Mode::MODE_AUTO:
-                                        case Mode::COOL:
-                                            this->target_temperature = payload.getTempratureC();
-                                            break;
-                                        default:
-                                            break;
-                                    }
+        void FrigidareClimate::performTransmit(uint32_t sendTimes) {
+            auto transmit = this->transmitter_->transmit();
+            remote_base::RemoteTransmitData *data = transmit.get_data();
 
-                                    this->payload = payload;
+            data->reset();
+            data->set_carrier_frequency(ActiveProtocol::CARRIER_FREQUENCY);
+            data->set_data(this->timings);
 
-                                    // And make that state known to the world (probably home assistant).
-                                    this->publish_state();
+            // Every frame already ends on the gap space, so only wait for whatever the configured gap adds to it.
+            transmit.set_send_times(sendTimes);
+            transmit.set_send_wait(this->repeatGap > ActiveProtocol::GAP_SPACE ? this->repeatGap - ActiveProtocol::GAP_SPACE : 0);
 
-                                    return true;
-                                } else {
-                                    // Bad checksum.
-                                    // Either corrupted or wasn't actually a message for us.
-                                    ESP_LOGD(TAG, "Checksum failed. Expected: %02x Got: %02x", calculatedChecksum, payload.getChecksum());
-                                }
-                            } else {
-                                ESP_LOGW(TAG, "Fan speed is invalid.");
-                            }
-                        } else {
-                            ESP_LOGW(TAG, "Swing Mode is invalid.");
-                        }
-                    } else {
-                        ESP_LOGW(TAG, "Mode is invalid.");
-                    }
-                } else {
-                    ESP_LOGW(TAG, "Magic number did not match.");
+            // And transmit!
+            transmit.perform();
+
+            // perform() returns once the burst is out, so echoes are timed from its end.
+            this->lastTransmitAt = millis();
+            this->framesTransmitted += sendTimes;
+        }
+
+        // The receiver only hands over a frame once it has been idle for a while, so give it time before repeating.
+        const uint32_t ADAPTIVE_REPEAT_MIN_DELAY_MS = 50;
+
+        void FrigidareClimate::scheduleRepeat() {
+            const uint32_t delay = std::max(ADAPTIVE_REPEAT_MIN_DELAY_MS, this->repeatGap / 1000);
+            this->set_timeout("repeat", delay, [this]() {
+                if (this->repeatsRemaining == 0) {
+                    return;
                 }
-            } else {
-                ESP_LOGW(TAG, "HEADER INVALID.");
-            }
 
-            return false;
+                this->repeatsRemaining -= 1;
+                this->performTransmit(1);
+                if (this->repeatsRemaining > 0) {
+                    this->scheduleRepeat();
+                }
+            });
         }
 
-        Payload::Payload() {
-            // It seems the controller defaults to 0xFF for a lot of defaults, so that's what we'll do to.
-            std::memset(this, 0x00, sizeof(*this));
+        // Timings per capture line. Keeps each line well inside the logger's buffer.
+        const size_t CAPTURE_LINE_TIMINGS = 24;
 
-            // Set some sane defaults, just in case something doesn't get set.
-            this->setSwingMode(SwingMode::SWING_OFF);
-            this->setTempratureC(32);
-            this->setFanSpeed(FanSpeed::FAN_LOW);
-            this->setMode(Mode::MODE_AUTO);
-            this->setPowered(false);
+        // Captures are logged as numbered chunks, which host/replay stitches back together:
+        //   capture <frame> <offset>: <timing> <timing> ...
+        //   capture <frame> end
+        void FrigidareClimate::captureFrame(const std::vector<int32_t> & timings) {
+            const uint32_t frame = this->capturedFrames;
+            this->capturedFrames += 1;
 
-            // Some kind of magic identification number the AC unit expects to see.
-            this->identity = 0xc3;
-            
-            this->sum = 0;
+            // Room for a sign, ten digits and a separator per timing.
+            char line[CAPTURE_LINE_TIMINGS * 12 + 1];
+            for (size_t offset = 0; offset < timings.size(); offset += CAPTURE_LINE_TIMINGS) {
+                const size_t end = std::min(offset + CAPTURE_LINE_TIMINGS, timings.size());
+                char * cursor = line;
+                for (size_t index = offset; index < end; index += 1) {
+                    cursor += std::snprintf(cursor, line + sizeof(line) - cursor, " %d", static_cast<int>(timings[index]));
+                }
+                ESP_LOGI(TAG, "capture %u %u:%s", frame, static_cast<unsigned>(offset), line);
+            }
+            ESP_LOGI(TAG, "capture %u end", frame);
         }
 
-        uint8_t Payload::getIdentity() {
-            return this->identity;
+        const char * pulseKindName(PulseKind kind) {
+            switch (kind) {
+                case PULSE_HEADER_MARK: return "header mark";
+                case PULSE_HEADER_SPACE: return "header space";
+                case PULSE_BIT_MARK: return "bit mark";
+                case PULSE_ONE_SPACE: return "one space";
+                case PULSE_ZERO_SPACE: return "zero space";
+                default: return "unknown";
+            }
         }
 
-        bool Payload::isPowered() {
-            return this->power == 1;
+        void PulseHistogram::add(const PulseWindow & range, int32_t duration) {
+            const int32_t bin = (duration - range.min) / binWidth(range);
+            this->bins[std::min(std::max(bin, static_cast<int32_t>(0)), static_cast<int32_t>(BINS - 1))] += 1;
+            this->count += 1;
+            this->total += duration;
         }
 
-        void Payload::setPowered(bool powered) {
-            this->power = powered ? 1:0;
+        int32_t PulseHistogram::lowerEdge(const PulseWindow & range, float fraction) const {
+            const uint32_t skip = this->count * fraction;
+            uint32_t seen = 0;
+            for (size_t bin = 0; bin < BINS; bin += 1) {
+                seen += this->bins[bin];
+                if (seen > skip) {
+                    return range.min + static_cast<int32_t>(bin) * binWidth(range);
+                }
+            }
+            return range.min;
         }
 
-        uint8_t Payload::getChecksum() {
-            return this->sum;
+        int32_t PulseHistogram::upperEdge(const PulseWindow & range, float fraction) const {
+            const uint32_t skip = this->count * fraction;
+            uint32_t seen = 0;
+            for (size_t bin = BINS; bin > 0; bin -= 1) {
+                seen += this->bins[bin - 1];
+                if (seen > skip) {
+                    return std::min(range.max, range.min + static_cast<int32_t>(bin) * binWidth(range) - 1);
+                }
+            }
+            return range.max;
         }
 
-        uint8_t Payload::getTempratureC() {
-            return 8 + this->temprature;
+        // The odd pulse stretched by sunlight or a flickering lamp shouldn't widen the windows for good.
+        const float CALIBRATION_OUTLIERS = 0.005f;
+
+        void FrigidareClimate::startCalibration() {
+            // Changing the protocol, or how calibration is done, starts over rather than loading something measured differently.
+            const uint32_t key = this->get_object_id_hash() ^ fnv1_hash("frigidaire_calibration") ^
+                (static_cast<uint32_t>(ActiveProtocol::HEADER_MARK) << 16) ^ (static_cast<uint32_t>(this->calibrationFrames) << 8) ^ this->calibrationMargin;
+            this->calibrationPreference = global_preferences->make_preference<CalibratedTimings>(key);
+
+            // Whatever is in flash has to at least look like something we could have saved.
+            CalibratedTimings saved;
+            if (this->calibrationPreference.load(&saved) && bitsAreDistinct(saved.windows)) {
+                bool plausible = true;
+                for (size_t kind = 0; kind < PULSE_KIND_COUNT; kind += 1) {
+                    const PulseWindow & nominal = NOMINAL_WINDOWS<ActiveProtocol>[kind];
+                    plausible = plausible && saved.windows[kind].min >= nominal.min && saved.windows[kind].max <= nominal.max &&
+                        saved.windows[kind].min <= saved.typical[kind] && saved.typical[kind] <= saved.windows[kind].max;
+                }
+
+                if (plausible) {
+                    ESP_LOGI(TAG, "Loaded saved timing calibration.");
+                    this->applyCalibration(saved);
+                    return;
+                }
+            }
+
+            ESP_LOGI(TAG, "Calibrating timings from the next %u frames from the remote.", this->calibrationFrames);
+            this->calibrationHistograms.reset(new std::array<PulseHistogram, PULSE_KIND_COUNT>());
+            this->calibrationSamples = 0;
         }
 
-        void Payload::setTempratureC(uint8_t temprature) {
-            this->temprature = std::min(std::max(temprature, FRIGIDAIRE_TEMP_C_MIN), FRIGIDAIRE_TEMP_C_MAX) - 8;
+        void FrigidareClimate::calibrateFrom(const std::vector<int32_t> & timings) {
+            // The decoder already accepted this, so every pulse is where it should be and inside the nominal windows.
+            const PulseWindows & nominal = NOMINAL_WINDOWS<ActiveProtocol>;
+            std::array<PulseHistogram, PULSE_KIND_COUNT> & histograms = *this->calibrationHistograms;
+
+            histograms[PULSE_HEADER_MARK].add(nominal[PULSE_HEADER_MARK], timings[0]);
+            histograms[PULSE_HEADER_SPACE].add(nominal[PULSE_HEADER_SPACE], -timings[1]);
+            for (size_t index = 2; index < 2 + 2 * 8 * ActiveProtocol::FRAME_LENGTH; index += 2) {
+                histograms[PULSE_BIT_MARK].add(nominal[PULSE_BIT_MARK], timings[index]);
+
+                const PulseKind space = nominal[PULSE_ONE_SPACE].matchesSpace(timings[index + 1]) ? PULSE_ONE_SPACE : PULSE_ZERO_SPACE;
+                histograms[space].add(nominal[space], -timings[index + 1]);
+            }
+
+            this->calibrationSamples += 1;
+            ESP_LOGD(TAG, "Calibration frame %u of %u.", this->calibrationSamples, this->calibrationFrames);
+            if (this->calibrationSamples >= this->calibrationFrames) {
+                this->finishCalibration();
+            }
         }
 
-        Mode Payload::getMode() {
-            switch (this->mode) {
-                case Mode::MODE_AUTO:
-                case Mode::COOL:
-                case Mode::DRY:
-                case Mode::FAN:
-                    return static_cast<Mode>(this->mode);
-                default:
-                    return Mode::MODE_INVALID;
+        void FrigidareClimate::finishCalibration() {
+            const PulseWindows & nominal = NOMINAL_WINDOWS<ActiveProtocol>;
+            const std::array<PulseHistogram, PULSE_KIND_COUNT> & histograms = *this->calibrationHistograms;
+
+            CalibratedTimings calibrated;
+            for (size_t kind = 0; kind < PULSE_KIND_COUNT; kind += 1) {
+                const PulseHistogram & histogram = histograms[kind];
+                if (histogram.size() == 0) {
+                    // Can't happen with our identity byte, but a kind we never saw keeps its nominal window.
+                    calibrated.windows[kind] = nominal[kind];
+                    calibrated.typical[kind] = (nominal[kind].min + nominal[kind].max) / 2;
+                    continue;
+                }
+
+                const int32_t typical = histogram.mean();
+                const int32_t margin = typical * this->calibrationMargin / 100;
+                calibrated.windows[kind] = PulseWindow {
+                    std::max(nominal[kind].min, histogram.lowerEdge(nominal[kind], CALIBRATION_OUTLIERS) - margin),
+                    std::min(nominal[kind].max, histogram.upperEdge(nominal[kind], CALIBRATION_OUTLIERS) + margin)
+                };
+                calibrated.typical[kind] = typical;
             }
+
+            this->calibrationHistograms.reset();
+
+            if (!bitsAreDistinct(calibrated.windows)) {
+                ESP_LOGW(TAG, "Calibrated zero and one spaces overlap, sticking to nominal timings. Try a smaller margin.");
+                return;
+            }
+
+            if (!this->calibrationPreference.save(&calibrated)) {
+                ESP_LOGW(TAG, "Couldn't save timing calibration, it will be redone after a reboot.");
+            }
+            this->applyCalibration(calibrated);
         }
 
-        void Payload::setMode(Mode mode) {
-            this->mode = mode;
+        void FrigidareClimate::applyCalibration(const CalibratedTimings & calibrated) {
+            this->calibration = calibrated;
+            this->calibrated = true;
+
+            for (size_t kind = 0; kind < PULSE_KIND_COUNT; kind += 1) {
+                ESP_LOGI(TAG, "Calibrated %s: %d-%dus, typically %uus.", pulseKindName(static_cast<PulseKind>(kind)),
+                    static_cast<int>(calibrated.windows[kind].min), static_cast<int>(calibrated.windows[kind].max), calibrated.typical[kind]);
+            }
+
+            if (this->calibrationTransmit) {
+                // The gap is never measured, since the receiver ends the frame before it's over.
+                this->calibratedTransmit.reset(new TransmitTimings(makeTransmitTimings(
+                    calibrated.typical[PULSE_HEADER_MARK], calibrated.typical[PULSE_HEADER_SPACE], calibrated.typical[PULSE_BIT_MARK],
+                    calibrated.typical[PULSE_ONE_SPACE], calibrated.typical[PULSE_ZERO_SPACE], ActiveProtocol::GAP_SPACE)));
+            }
         }
 
-        SwingMode Payload::getSwingMode() {
-            switch (this->swing) {
-                case SwingMode::SWING_ON:
-                case SwingMode::SWING_OFF:
-                    return static_cast<SwingMode>(this->swing);
-                default:
-                    return SwingMode::SWING_INVALID;
+        bool FrigidareClimate::on_receive(remote_base::RemoteReceiveData data) {
+            if (this->capture) {
+                this->captureFrame(*data.get_raw_data());
             }
+
+            const FrameStatus status = this->receiveFrame(*data.get_raw_data());
+
+            this->framesReceived += 1;
+            this->frameStatusCounts[status] += 1;
+
+            // Only the remote's frames are worth measuring. Echoes are just our own timings coming back.
+            if (status == FRAME_ACCEPTED && this->calibrationHistograms) {
+                this->calibrateFrom(*data.get_raw_data());
+            }
+
+            return status == FRAME_ACCEPTED || status == FRAME_ECHO;
         }
 
-        void Payload::setSwingMode(SwingMode swing) {
-            this->swing = swing;
+        // Whether a frame heard now could be our own coming back.
+        bool FrigidareClimate::echoExpected() const {
+            return this->echoWindow != 0 && this->lastSentValid && millis() - this->lastTransmitAt <= this->echoWindow;
         }
 
-        FanSpeed Payload::getFanSpeed() {
-            switch (this->fanSpeed) {
-                case FanSpeed::FAN_AUTO:
-                case FanSpeed::FAN_HIGH:
-                case FanSpeed::FAN_MID:
-                case FanSpeed::FAN_LOW:
-                    return static_cast<FanSpeed>(this->fanSpeed);
-                default:
-                    return FanSpeed::FAN_INVALID;
+        FrameStatus FrigidareClimate::receiveFrame(const std::vector<int32_t> & timings) {
+            const uint32_t start = micros();
+
+            // remote_receiver only calls its listeners once the line has gone idle, with the whole buffer, and offers nothing
+            // per edge that a climate_ir platform could hook into. So there's no decoding while the frame is still arriving.
+            Frame raw;
+            FrameStatus decoded = decodeFrame(timings, this->calibrated ? this->calibration.windows : NOMINAL_WINDOWS<ActiveProtocol>, raw);
+
+            // Calibrated windows fit the remote, but unless we transmit at its timings too, our own frames still go out at nominal ones
+            // and can miss them. Right after a transmit, give the frame a second look at nominal, and keep it only if it's ours.
+            if (decoded != FRAME_ACCEPTED && this->calibrated && !this->calibratedTransmit && this->echoExpected()) {
+                Frame nominal;
+                if (decodeFrame(timings, NOMINAL_WINDOWS<ActiveProtocol>, nominal) == FRAME_ACCEPTED && nominal == this->lastSent) {
+                    raw = nominal;
+                    decoded = FRAME_ACCEPTED;
+                }
             }
-        }
 
-        void Payload::setFanSpeed(FanSpeed fanSpeed) {
-            this->fanSpeed = fanSpeed;
+            if (decoded != FRAME_ACCEPTED) {
+                // Don't let every foreign remote in the room drag the minimum down.
+                if (decoded != FRAME_BAD_HEADER) {
+                    this->decodeTimes.add(micros() - start);
+                }
+
+                // Every other remote in the room lands here, NEC ones even share our header timing.
+                // That's normal, so don't make noise about it.
+                ESP_LOGV(TAG, "Ignoring frame: %s", frameStatusName(decoded));
+                return decoded;
+            }
+
+            Payload payload = Payload::unpack(raw);
+            const uint8_t calculatedChecksum = ActiveProtocol::checksum(raw);
+
+            // That's the decoding done. Logging, applying, publishing and calibrating aren't the codec's cost, so they stay off the clock.
+            this->decodeTimes.add(micros() - start);
+
+            // When the transmitter and receiver share a node, everything we send comes straight back.
+            // It tells the unit nothing new, so it doesn't need validating, applying or publishing.
+            if (this->echoExpected() && (raw == this->lastSent || (this->displayButton != nullptr && raw == this->lastDisplayToggle))) {
+                // It did make it into the room though, so the rest of the repeats aren't needed.
+                if (this->repeatsRemaining > 0) {
+                    ESP_LOGD(TAG, "Heard our own frame, skipping %u repeats.", this->repeatsRemaining);
+                    this->repeatsRemaining = 0;
+                    this->cancel_timeout("repeat");
+                }
+                return FRAME_ECHO;
+            }
+
+            logFrame("RX", raw);
+
+            // Somebody pressed display on the remote. That has happened now, and keeping it would flip the display again
+            // with every frame we send after.
+            if (this->displayButton != nullptr && payload.isDisplayToggle()) {
+                payload.setDisplayToggle(false);
+                raw = payload.pack();
+                raw.back() = ActiveProtocol::checksum(raw);
+            }
+
+            if (payload.getIdentity() == ActiveProtocol::IDENTITY) {
+                // Okay, so we had enough bits worth of data.
+                // Now we have to validate that data.
+
+                // Validate the mode.
+                if (payload.getMode() != Mode::MODE_INVALID) {
+                    // Validate the swing.
+                    if (payload.getSwingMode() != SwingMode::SWING_INVALID) {
+                        // Validate the fan speed.
+                        if (payload.getFanSpeed() != FanSpeed::FAN_INVALID) {
+                            // Validate the checksum.
+                            if (calculatedChecksum == payload.getChecksum()) {
+                                ESP_LOGD(TAG, "Checksum passed.");
+
+                                // Everything is valid!
+                                // Apply the state!
+
+                                // Remotes like to send the same frame over and over, and there's no point telling anyone about those.
+                                const climate::ClimateMode previousMode = this->mode;
+                                const optional<climate::ClimateFanMode> previousFanMode = this->fan_mode;
+                                const climate::ClimateSwingMode previousSwingMode = this->swing_mode;
+                                const float previousTargetTemperature = this->target_temperature;
+                                const optional<climate::ClimatePreset> previousPreset = this->preset;
+                                const climate::ClimateAction previousAction = this->action;
+
+                                // Powered is special since the controller doesn't consider it a mode.
+                                if (payload.isPowered()) {
+                                    // It's on, so we need to get the mode.
+                                    switch (payload.getMode()) {
+                                        case Mode::MODE_AUTO:
+                                            this->mode = climate::CLIMATE_MODE_AUTO;
+                                            break;
+                                        case Mode::COOL:
+                                            this->mode = climate::CLIMATE_MODE_COOL;
+                                            break;
+                                        case Mode::DRY:
+                                            this->mode = climate::CLIMATE_MODE_DRY;
+                                            break;
+                                        case Mode::FAN:
+                                            this->mode = climate::CLIMATE_MODE_FAN_ONLY;
+                                            break;
+                                        default:
+                                            // Should be impossible at this point.
+                                            ESP_LOGW(TAG, "Impossible mode: %02x", payload.getMode());
+                                            break;
+                                    }
+                                } else {
+                                    // It's off.
+                                    this->mode = climate::CLIMATE_MODE_OFF;
+
+                                    // When the controller turns us off, it sends an invalid temprature, so just reset to the previous temprature setting.
+                                    payload.setTempratureC(this->target_temperature);
+                                }
+
+                                switch (payload.getFanSpeed()) {
+                                    case FanSpeed::FAN_AUTO:
+                                        this->fan_mode = climate::CLIMATE_FAN_AUTO;
+                                        break;
+                                    case FanSpeed::FAN_HIGH:
+                                        this->fan_mode = climate::CLIMATE_FAN_HIGH;
+                                        break;
+                                    case FanSpeed::FAN_MID:
+                                        this->fan_mode = climate::CLIMATE_FAN_MEDIUM;
+                                        break;
+                                    case FanSpeed::FAN_LOW:
+                                        this->fan_mode = climate::CLIMATE_FAN_LOW;
+                                        break;
+                                    default:
+                                        // Should be impossible at this point.
+                                        ESP_LOGW(TAG, "Impossible fan speed: %02x", payload.getFanSpeed());
+                                        break;
+                                }
+
+                                switch (payload.getSwingMode()) {
+                                    case SwingMode::SWING_ON:
+                                        this->swing_mode = climate::CLIMATE_SWING_VERTICAL;
+                                        break;
+                                    case SwingMode::SWING_OFF:
+                                        this->swing_mode = climate::CLIMATE_SWING_OFF;
+                                        break;
+                                    default:
+                                        // SHould be impossible at this point.
+                                        ESP_LOGW(TAG, "Impossible swing mode: %02x", payload.getSwingMode());
+                                        break;
+                                }
+
+                                // The thermostat has to follow what the unit was actually told, or it keeps believing its own last frame.
+                                if (this->thermostat) {
+                                    if (this->mode == climate::CLIMATE_MODE_COOL) {
+                                        // Somebody picked up the remote and asked for cooling, so that's what the unit is doing now,
+                                        // even if the thermostat had it idling.
+                                        if (previousMode != climate::CLIMATE_MODE_COOL || !this->thermostatCooling) {
+                                            this->startThermostatCycle(true);
+                                        }
+                                    } else if (this->mode == climate::CLIMATE_MODE_FAN_ONLY && previousMode == climate::CLIMATE_MODE_COOL) {
+                                        // The thermostat idles by sending fan mode. If that's all this frame is, we're still in cool, just resting.
+                                        Payload idle = this->payload;
+                                        idle.setMode(Mode::FAN);
+                                        Frame idleFrame = idle.pack();
+                                        idleFrame.back() = ActiveProtocol::checksum(idleFrame);
+
+                                        if (idleFrame == raw) {
+                                            this->mode = climate::CLIMATE_MODE_COOL;
+                                            if (this->thermostatCooling) {
+                                                this->startThermostatCycle(false);
+                                            }
+                                        }
+                                    }
+                                    this->updateAction();
+                                }
+
+                                if (this->supportsTurbo) {
+                                    this->preset = payload.isTurbo() ? climate::CLIMATE_PRESET_BOOST : climate::CLIMATE_PRESET_NONE;
+                                }
+
+                                // Only change the temprature if we're in auto or cooling mode.
+                                switch (payload.getMode()) {
+                                    case Mode::MODE_AUTO:
+                                    case Mode::COOL:
+                                        this->target_temperature = payload.getTempratureC();
+                                        break;
+                                    default:
+                                        break;
+                                }
+
+                                this->payload = payload;
+                                this->schedulePersist();
+
+                                // If the remote told the unit something else, what we sent last no longer describes it.
+                                if (this->lastSentValid && this->lastSent != raw) {
+                                    this->lastSentValid = false;
+                                }
+
+                                if (this->mode != previousMode || this->fan_mode != previousFanMode ||
+                                    this->swing_mode != previousSwingMode || this->target_temperature != previousTargetTemperature ||
+                                    this->preset != previousPreset || this->action != previousAction) {
+                                    // And make that state known to the world (probably home assistant).
+                                    this->publishReceivedState();
+                                } else {
+                                    ESP_LOGV(TAG, "State unchanged, not publishing.");
+                                }
+
+                                return FRAME_ACCEPTED;
+                            } else {
+                                // Bad checksum.
+                                // Either corrupted or wasn't actually a message for us.
+                                ESP_LOGD(TAG, "Checksum failed. Expected: %02x Got: %02x", calculatedChecksum, payload.getChecksum());
+                                return FRAME_BAD_CHECKSUM;
+                            }
+                        } else {
+                            ESP_LOGW(TAG, "Fan speed is invalid.");
+                            return FRAME_BAD_FAN;
+                        }
+                    } else {
+                        ESP_LOGW(TAG, "Swing Mode is invalid.");
+                        return FRAME_BAD_SWING;
+                    }
+                } else {
+                    ESP_LOGW(TAG, "Mode is invalid.");
+                    return FRAME_BAD_MODE;
+                }
+            } else {
+                ESP_LOGV(TAG, "Magic number did not match.");
+                return FRAME_BAD_IDENTITY;
+            }
         }
     }
-}
\ No newline at end of file
+}
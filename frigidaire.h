@@ -3,7 +3,14 @@
 
 #include "esphome.h"
 #include "esphome/components/climate/climate.h"
+#include "esphome/components/button/button.h"
 #include "esphome/components/climate_ir/climate_ir.h"
+#include "esphome/components/sensor/sensor.h"
+#include "frigidaire_protocol.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
 
 namespace esphome {
     namespace frigidaire {
@@ -34,55 +41,320 @@ namespace esphome {
             FAN_INVALID = 0xFF,
         };
 
+        // Where a field lives in the frame: the byte, and the bit within it counting from the least significant.
+        struct Field {
+            uint8_t byte;
+            uint8_t shift;
+            uint8_t width;
+
+            constexpr uint8_t mask() const {
+                return static_cast<uint8_t>(((1u << this->width) - 1) << this->shift);
+            }
+        };
+
+        // The frame is packed and unpacked with plain shifts and masks rather than bitfields,
+        // so the layout doesn't depend on what the compiler decides to do with them.
+        // Every bit is kept, so whatever the remote set that we don't understand (timers, sleep)
+        // goes back out untouched when we only change the fields we do.
         class Payload {
+            public:
+                static constexpr size_t LENGTH = 13;
+
+                static constexpr Field IDENTITY   {0, 0, 8};
+                static constexpr Field SWING      {1, 0, 3};
+                static constexpr Field TEMPRATURE {1, 3, 5};
+                static constexpr Field FAN_SPEED  {4, 4, 4};
+                static constexpr Field MODE       {6, 5, 3};
+                static constexpr Field POWER      {9, 5, 1};
+                // The rest of the frame lines up with the Electra/AUX layout (IRremoteESP8266's ir_Electra), so the extras are taken from it too.
+                // Only where our own captures agree though: they carry 0x05 in byte 11, which is the display left alone there.
+                // Neither is confirmed on every Frigidaire unit, which is why both are opt-in.
+                static constexpr Field TURBO      {5, 6, 1};
+                // Not a state but a button press: the unit flips its display when it sees 0x15 (or 0x19), and ignores 0x05 (or 0x08).
+                static constexpr Field DISPLAY    {11, 0, 5};
+                static constexpr uint8_t DISPLAY_TOGGLE = 0x15;
+                static constexpr uint8_t DISPLAY_TOGGLE_MASK = 0x11;
+                static constexpr Field SUM        {12, 0, 8};
+
+                constexpr Payload() : raw() {
+                    // Set some sane defaults, just in case something doesn't get set.
+                    this->setSwingMode(SwingMode::SWING_OFF);
+                    this->setTempratureC(32);
+                    this->setFanSpeed(FanSpeed::FAN_LOW);
+                    this->setMode(Mode::MODE_AUTO);
+                    this->setPowered(false);
+
+                    // Some kind of magic identification number the AC unit expects to see.
+                    this->set(IDENTITY, ActiveProtocol::IDENTITY);
+                }
+
+                static constexpr Payload unpack(const std::array<uint8_t, LENGTH> & raw) {
+                    Payload payload;
+                    payload.raw = raw;
+                    return payload;
+                }
+
+                constexpr std::array<uint8_t, LENGTH> pack() const {
+                    return this->raw;
+                }
+
+                constexpr uint8_t getIdentity() const {
+                    return this->get(IDENTITY);
+                }
+
+                constexpr bool isPowered() const {
+                    return this->get(POWER) == 1;
+                }
+
+                constexpr void setPowered(bool powered) {
+                    this->set(POWER, powered ? 1:0);
+                }
+
+                constexpr bool isTurbo() const {
+                    return this->get(TURBO) == 1;
+                }
+
+                constexpr void setTurbo(bool turbo) {
+                    this->set(TURBO, turbo ? 1:0);
+                }
+
+                constexpr bool isDisplayToggle() const {
+                    return (this->get(DISPLAY) & DISPLAY_TOGGLE_MASK) == DISPLAY_TOGGLE_MASK;
+                }
+
+                // Off only clears bit 4, the one every known toggle value has and no idle one does, so 0x15 goes back to 0x05.
+                constexpr void setDisplayToggle(bool toggle) {
+                    this->set(DISPLAY, toggle ? DISPLAY_TOGGLE : this->get(DISPLAY) & ~0x10);
+                }
+
+                constexpr uint8_t getChecksum() const {
+                    return this->get(SUM);
+                }
+
+                constexpr uint8_t getTempratureC() const {
+                    return 8 + this->get(TEMPRATURE);
+                }
+
+                // Clamped while it's still a float, since converting one out of range is undefined. NaN fails both tests and ends up at the minimum.
+                constexpr void setTempratureC(float temprature) {
+                    const uint8_t clamped = temprature >= FRIGIDAIRE_TEMP_C_MAX ? FRIGIDAIRE_TEMP_C_MAX
+                        : temprature >= FRIGIDAIRE_TEMP_C_MIN ? static_cast<uint8_t>(temprature) : FRIGIDAIRE_TEMP_C_MIN;
+                    this->set(TEMPRATURE, clamped - 8);
+                }
+
+                constexpr Mode getMode() const {
+                    switch (this->get(MODE)) {
+                        case Mode::MODE_AUTO:
+                        case Mode::COOL:
+                        case Mode::DRY:
+                        case Mode::FAN:
+                            return static_cast<Mode>(this->get(MODE));
+                        default:
+                            return Mode::MODE_INVALID;
+                    }
+                }
+
+                constexpr void setMode(Mode mode) {
+                    this->set(MODE, mode);
+                }
+
+                constexpr SwingMode getSwingMode() const {
+                    switch (this->get(SWING)) {
+                        case SwingMode::SWING_ON:
+                        case SwingMode::SWING_OFF:
+                            return static_cast<SwingMode>(this->get(SWING));
+                        default:
+                            return SwingMode::SWING_INVALID;
+                    }
+                }
+
+                constexpr void setSwingMode(SwingMode swing) {
+                    this->set(SWING, swing);
+                }
+
+                constexpr FanSpeed getFanSpeed() const {
+                    switch (this->get(FAN_SPEED)) {
+                        case FanSpeed::FAN_AUTO:
+                        case FanSpeed::FAN_HIGH:
+                        case FanSpeed::FAN_MID:
+                        case FanSpeed::FAN_LOW:
+                            return static_cast<FanSpeed>(this->get(FAN_SPEED));
+                        default:
+                            return FanSpeed::FAN_INVALID;
+                    }
+                }
+
+                constexpr void setFanSpeed(FanSpeed fanSpeed) {
+                    this->set(FAN_SPEED, fanSpeed);
+                }
+
             private:
-                // Byte 0
-                uint8_t identity   :8;
-                // Byte 1
-                uint8_t swing      :3;
-                uint8_t temprature :5;
-                // Byte 2
-                uint8_t            :8;
-                // Byte 3
-                uint8_t            :8;
-                // Byte 4
-                uint8_t            :4;
-                uint8_t fanSpeed   :4;
-                // Byte 5
-                uint8_t            :8;
-                // Byte 6
-                uint8_t            :5;
-                uint8_t mode       :3;
-                // Byte 7
-                uint8_t            :8;
-                // Byte 8
-                uint8_t            :8;
-                // Byte 9
-                uint8_t            :5;
-                uint8_t power      :1;
-                uint8_t            :2;
-                // Byte 10
-                uint8_t            :8;
-                // Byte 11
-                uint8_t            :8;
-                // Byte 12
-                uint8_t sum        :8;
+                constexpr uint8_t get(Field field) const {
+                    return (this->raw[field.byte] & field.mask()) >> field.shift;
+                }
+
+                // Only the field's bits are touched, everything else in the byte is kept as it was.
+                constexpr void set(Field field, uint8_t value) {
+                    this->raw[field.byte] = (this->raw[field.byte] & ~field.mask()) | ((value << field.shift) & field.mask());
+                }
+
+                std::array<uint8_t, LENGTH> raw;
+        };
+
+        static_assert(ActiveProtocol::FRAME_LENGTH == Payload::LENGTH, "Payload only knows the layout of 13 byte frames.");
+
+        // A frame as it goes over the air, checksum included.
+        typedef ActiveProtocol::Frame Frame;
+
+        // What became of a received frame. Everything after FRAME_ECHO is a reason it was rejected.
+        enum FrameStatus : uint8_t {
+            FRAME_ACCEPTED,
+            FRAME_ECHO,
+            FRAME_BAD_HEADER,
+            FRAME_TOO_SHORT,
+            FRAME_BAD_IDENTITY,
+            FRAME_BAD_MODE,
+            FRAME_BAD_SWING,
+            FRAME_BAD_FAN,
+            FRAME_BAD_CHECKSUM,
+            FRAME_STATUS_COUNT
+        };
+
+        enum DurationStat : uint8_t {
+            DURATION_MIN,
+            DURATION_AVG,
+            DURATION_MAX,
+            DURATION_STAT_COUNT
+        };
+
+        // Min, average and max of a set of durations, in microseconds.
+        class DurationStats {
             public:
-                Payload();
-
-                bool isPowered();
-                void setPowered(bool powered);
-                uint8_t getChecksum();
-                uint8_t getTempratureC();
-                void setTempratureC(uint8_t temprature);
-                Mode getMode();
-                void setMode(Mode mode);
-                SwingMode getSwingMode();
-                void setSwingMode(SwingMode swing);
-                FanSpeed getFanSpeed();
-                void setFanSpeed(FanSpeed fanSpeed);
+                void add(uint32_t duration) {
+                    this->min = std::min(this->min, duration);
+                    this->max = std::max(this->max, duration);
+                    this->total += duration;
+                    this->count += 1;
+                }
+
+                bool empty() const {
+                    return this->count == 0;
+                }
+
+                float get(DurationStat stat) const {
+                    switch (stat) {
+                        case DURATION_MIN:
+                            return this->min;
+                        case DURATION_MAX:
+                            return this->max;
+                        default:
+                            return static_cast<float>(this->total) / this->count;
+                    }
+                }
+
+                void reset() {
+                    *this = DurationStats();
+                }
+
+            private:
+                uint32_t min = UINT32_MAX;
+                uint32_t max = 0;
+                uint64_t total = 0;
+                uint32_t count = 0;
+        };
+
+        // The kinds of pulse a frame is made of. The gap at the end is left out since it's never measured.
+        enum PulseKind : uint8_t {
+            PULSE_HEADER_MARK,
+            PULSE_HEADER_SPACE,
+            PULSE_BIT_MARK,
+            PULSE_ONE_SPACE,
+            PULSE_ZERO_SPACE,
+            PULSE_KIND_COUNT
+        };
+
+        // The range of durations, in microseconds, accepted for a kind of pulse.
+        struct PulseWindow {
+            int32_t min;
+            int32_t max;
+
+            // Within tolerance percent of nominal either way.
+            static constexpr PulseWindow around(uint16_t nominal, uint8_t tolerance) {
+                return PulseWindow {
+                    static_cast<int32_t>(nominal) * (100 - tolerance) / 100,
+                    static_cast<int32_t>(nominal) * (100 + tolerance) / 100
+                };
+            }
+
+            constexpr bool matchesMark(int32_t duration) const {
+                return duration >= this->min && duration <= this->max;
+            }
+
+            // Spaces are stored negative.
+            constexpr bool matchesSpace(int32_t duration) const {
+                return -duration >= this->min && -duration <= this->max;
+            }
         };
 
+        typedef std::array<PulseWindow, PULSE_KIND_COUNT> PulseWindows;
+
+        // Reads the bits of a frame in one pass over the timings, marks positive and spaces negative.
+        // Returns why the frame was rejected, or FRAME_ACCEPTED if it was decoded into raw.
+        FrameStatus decodeFrame(const std::vector<int32_t> & timings, const PulseWindows & windows, Frame & raw);
+
+        // Mark/space timings for the four bits of a nibble, least significant bit first.
+        // Spaces are negative, the same as remote_base stores them.
+        typedef std::array<int32_t, 2 * 4> NibbleTimings;
+
+        // Everything the encoder needs to lay out a frame.
+        struct TransmitTimings {
+            int32_t headerMark;
+            int32_t headerSpace;
+            int32_t bitMark;
+            int32_t gapSpace;
+            // A nibble table rather than a byte table keeps this at 512 bytes, which matters on the ESP8266 where rodata lives in RAM.
+            std::array<NibbleTimings, 16> nibbles;
+        };
+
+        // What calibration learnt about one unit's remote. This is what gets saved to flash.
+        struct CalibratedTimings {
+            PulseWindows windows;
+            // The average duration of each kind of pulse.
+            std::array<uint16_t, PULSE_KIND_COUNT> typical;
+        };
+
+        // Durations seen for one kind of pulse while calibrating, binned across the window the decoder accepts for it.
+        class PulseHistogram {
+            public:
+                static constexpr size_t BINS = 32;
+
+                void add(const PulseWindow & range, int32_t duration);
+
+                uint32_t size() const {
+                    return this->count;
+                }
+
+                int32_t mean() const {
+                    return this->count == 0 ? 0 : static_cast<int32_t>(this->total / this->count);
+                }
+
+                // Lower edge of the bin below which no more than fraction of the samples fall.
+                int32_t lowerEdge(const PulseWindow & range, float fraction) const;
+                // Upper edge of the bin above which no more than fraction of the samples fall.
+                int32_t upperEdge(const PulseWindow & range, float fraction) const;
+
+            private:
+                static int32_t binWidth(const PulseWindow & range) {
+                    return (range.max - range.min) / static_cast<int32_t>(BINS) + 1;
+                }
+
+                std::array<uint16_t, BINS> bins {};
+                uint32_t count = 0;
+                uint64_t total = 0;
+        };
+
+        class DisplayButton;
+
         class FrigidareClimate: public climate_ir::ClimateIR {
             public:
                 FrigidareClimate() : climate_ir::ClimateIR(
@@ -90,13 +362,179 @@ namespace esphome {
                     static_cast<float>(FRIGIDAIRE_TEMP_C_MAX),
                     FRIGIDAIR_TEMP_C_STEP) {}
 
-                // void control(const climate::ClimateCall &call) override;
+                void setup() override;
                 climate::ClimateTraits traits() override;
+
+                // Offer turbo as the boost preset. Off leaves the turbo bit however the remote last set it.
+                void set_supports_turbo(bool supports) { this->supportsTurbo = supports; }
+
+                // Toggle the unit's display with this button. Without one, byte 11 is left however the remote last set it.
+                void set_display_button(DisplayButton *button) { this->displayButton = button; }
+                // Sends the current state once, with the display toggle set.
+                void toggleDisplay();
+
+                // Run the thermostat here off the climate's sensor. In cool mode, the unit is switched between cooling
+                // and just running the fan to hold the target within plus or minus hysteresis degrees.
+                void set_thermostat(bool thermostat) { this->thermostat = thermostat; }
+                void set_thermostat_hysteresis(float hysteresis) { this->thermostatHysteresis = hysteresis; }
+                // Milliseconds the compressor stays on or off before it may be switched again.
+                void set_thermostat_min_cycle(uint32_t cycle) { this->thermostatMinCycle = cycle; }
+
+                // Control calls within this many milliseconds of each other go out as one frame. Zero sends every call.
+                void set_transmit_coalesce_window(uint32_t window) { this->coalesceWindow = window; }
+                // Don't send a frame identical to the one we sent last.
+                void set_suppress_duplicates(bool suppress) { this->suppressDuplicates = suppress; }
+                // ...unless it went out more than this many milliseconds ago. The unit may have missed it, and we can't tell without a receiver.
+                void set_duplicate_window(uint32_t window) { this->duplicateWindow = window; }
+                // Resend the last frame every this many milliseconds, for units that missed it. Zero turns it off.
+                void set_refresh_interval(uint32_t interval) { this->refreshInterval = interval; }
+                // Send every frame this many extra times.
+                void set_repeat_count(uint8_t count) { this->repeatCount = count; }
+                // Microseconds of silence between repeats. Never shorter than the gap that ends every frame.
+                void set_repeat_gap(uint32_t gap) { this->repeatGap = gap; }
+                // Send repeats one at a time, and stop as soon as the receiver hears one of them.
+                void set_repeat_adaptive(bool adaptive) { this->repeatAdaptive = adaptive; }
+                // Our own frame heard within this many milliseconds of sending it is an echo, and is dropped. Zero turns it off. Adaptive repeats rely on it.
+                void set_echo_window(uint32_t window) { this->echoWindow = window; }
+                // State changes from the remote are published at most once per this many milliseconds. Zero publishes every one.
+                void set_min_publish_interval(uint32_t interval) { this->minPublishInterval = interval; }
+
+                // Log the raw timings of every frame we receive, for replaying on a host.
+                void set_capture(bool capture) { this->capture = capture; }
+
+                // Save the last frame sent or received, and restore it at boot so the first transmit starts from what the unit was last told.
+                void set_persist_payload(bool persist) { this->persistPayload = persist; }
+                // Write the saved frame at most once per this many milliseconds, so a burst of changes costs one flash write.
+                void set_persist_delay(uint32_t delay) { this->persistDelay = delay; }
+
+                // Measure this many frames from the remote and tighten the decoder's windows around what it actually sends.
+                // The result is saved, so it only happens once per unit. Zero sticks to the nominal timings.
+                void set_calibration_frames(uint16_t frames) { this->calibrationFrames = frames; }
+                // Slack added either side of the measured range, in percent of the typical duration.
+                void set_calibration_margin(uint8_t margin) { this->calibrationMargin = margin; }
+                // Transmit at the measured timings instead of the nominal ones, to sound more like the real remote.
+                void set_calibration_transmit(bool transmit) { this->calibrationTransmit = transmit; }
+
+                // Diagnostics, published every statistics interval.
+                void set_statistics_interval(uint32_t interval) { this->statisticsInterval = interval; }
+                void set_received_sensor(sensor::Sensor *sensor) { this->receivedSensor = sensor; }
+                void set_transmitted_sensor(sensor::Sensor *sensor) { this->transmittedSensor = sensor; }
+                void set_frame_status_sensor(FrameStatus status, sensor::Sensor *sensor) { this->frameStatusSensors[status] = sensor; }
+                void set_decode_time_sensor(DurationStat stat, sensor::Sensor *sensor) { this->decodeTimeSensors[stat] = sensor; }
+                void set_encode_time_sensor(DurationStat stat, sensor::Sensor *sensor) { this->encodeTimeSensors[stat] = sensor; }
             protected:
+                void control(const climate::ClimateCall &call) override;
                 void transmit_state() override;
                 bool on_receive(remote_base::RemoteReceiveData data) override;
             private:
+                climate::ClimateTraits buildTraits() const;
+                void scheduleTransmit();
+                bool echoExpected() const;
+                FrameStatus receiveFrame(const std::vector<int32_t> & timings);
+                void publishReceivedState();
+                void captureFrame(const std::vector<int32_t> & timings);
+                bool hasStatisticsSensors() const;
+                void publishStatistics();
+                void sendFrame(const Frame & raw);
+                void sendDisplayToggle(const Frame & state);
+                void performTransmit(uint32_t sendTimes);
+                void scheduleRepeat();
+                void startThermostatCycle(bool cooling);
+                bool updateThermostat();
+                void updateAction();
+                void restorePayload();
+                void schedulePersist();
+                void startCalibration();
+                void calibrateFrom(const std::vector<int32_t> & timings);
+                void finishCalibration();
+                void applyCalibration(const CalibratedTimings & calibrated);
+
                 Payload payload;
+                std::vector<int32_t> timings;
+
+                bool supportsTurbo = false;
+                DisplayButton *displayButton = nullptr;
+                bool displayTogglePending = false;
+                // Heard back within the echo window, it's ours like any other frame.
+                Frame lastDisplayToggle {};
+
+                bool thermostat = false;
+                float thermostatHysteresis = 0.5f;
+                uint32_t thermostatMinCycle = 300000;
+                // Whether the unit is being told to cool, or only to run the fan, while in cool mode.
+                bool thermostatCooling = true;
+                uint32_t thermostatCycleStart = 0;
+
+                climate::ClimateTraits cachedTraits;
+                bool traitsBuilt = false;
+
+                uint32_t coalesceWindow = 0;
+                bool transmitPending = false;
+                uint32_t firstPendingChange = 0;
+
+                bool suppressDuplicates = true;
+                uint32_t duplicateWindow = 10000;
+                uint32_t refreshInterval = 0;
+                // What the unit should currently be doing as far as we know, or nothing if the remote changed it since.
+                Frame lastSent;
+                bool lastSentValid = false;
+
+                uint8_t repeatCount = 0;
+                uint32_t repeatGap = 0;
+                bool repeatAdaptive = false;
+                uint8_t repeatsRemaining = 0;
+
+                uint32_t echoWindow = 500;
+                uint32_t lastTransmitAt = 0;
+
+                uint32_t minPublishInterval = 0;
+                uint32_t lastPublishAt = 0;
+
+                bool capture = false;
+                uint32_t capturedFrames = 0;
+
+                bool persistPayload = true;
+                uint32_t persistDelay = 30000;
+                bool persistPending = false;
+                ESPPreferenceObject payloadPreference;
+                // What's in flash, so an unchanged payload isn't written again.
+                Frame persisted {};
+
+                uint16_t calibrationFrames = 0;
+                uint8_t calibrationMargin = 5;
+                bool calibrationTransmit = false;
+                ESPPreferenceObject calibrationPreference;
+                // Only around while frames are being measured.
+                std::unique_ptr<std::array<PulseHistogram, PULSE_KIND_COUNT>> calibrationHistograms;
+                uint16_t calibrationSamples = 0;
+                CalibratedTimings calibration;
+                bool calibrated = false;
+                // Only around when transmitting at the calibrated timings.
+                std::unique_ptr<TransmitTimings> calibratedTransmit;
+
+                uint32_t framesReceived = 0;
+                uint32_t framesTransmitted = 0;
+                std::array<uint32_t, FRAME_STATUS_COUNT> frameStatusCounts {};
+                DurationStats decodeTimes;
+                DurationStats encodeTimes;
+
+                uint32_t statisticsInterval = 60000;
+                sensor::Sensor *receivedSensor = nullptr;
+                sensor::Sensor *transmittedSensor = nullptr;
+                std::array<sensor::Sensor *, FRAME_STATUS_COUNT> frameStatusSensors {};
+                std::array<sensor::Sensor *, DURATION_STAT_COUNT> decodeTimeSensors {};
+                std::array<sensor::Sensor *, DURATION_STAT_COUNT> encodeTimeSensors {};
+        };
+
+        class DisplayButton : public button::Button {
+            public:
+                explicit DisplayButton(FrigidareClimate *parent) : parent(parent) {}
+
+            protected:
+                void press_action() override { this->parent->toggleDisplay(); }
+
+            private:
+                FrigidareClimate *parent;
         };
     }
 }
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+    namespace frigidaire {
+        // Everything about how a frame goes over the air: timings in microseconds, length, identity byte and checksum.
+        // All of it is constexpr, so none of it costs anything at runtime.
+        template<uint16_t headerMark, uint16_t headerSpace, uint16_t bitMark, uint16_t oneSpace, uint16_t zeroSpace, uint16_t gapSpace,
+                 size_t frameLength, uint8_t identity>
+        struct ProtocolDescriptor {
+            static constexpr uint16_t HEADER_MARK = headerMark;
+            static constexpr uint16_t HEADER_SPACE = headerSpace;
+            static constexpr uint16_t BIT_MARK = bitMark;
+            static constexpr uint16_t ONE_SPACE = oneSpace;
+            static constexpr uint16_t ZERO_SPACE = zeroSpace;
+            static constexpr uint16_t GAP_SPACE = gapSpace;
+            static constexpr uint32_t CARRIER_FREQUENCY = 38000;
+
+            static constexpr size_t FRAME_LENGTH = frameLength;
+            static constexpr uint8_t IDENTITY = identity;
+
+            // The header pair, a mark/space pair per bit, then the trailing mark and gap.
+            static constexpr size_t FRAME_TIMINGS = 2 + 2 * 8 * FRAME_LENGTH + 2;
+
+            typedef std::array<uint8_t, FRAME_LENGTH> Frame;
+
+            // The last byte is the sum of all the others.
+            static constexpr uint8_t checksum(const Frame & raw) {
+                uint8_t calculatedChecksum = 0x0;
+                for (size_t byte = 0; byte < raw.size() - 1; byte += 1) {
+                    calculatedChecksum += raw[byte];
+                }
+
+                return calculatedChecksum;
+            }
+        };
+
+        // Timed off the Frigidaire remote this component was written against.
+        typedef ProtocolDescriptor<8968, 4425, 600, 1650, 500, 8968, 13, 0xc3> FrigidaireProtocol;
+
+        // The only layout verified against real units so far. The payload, encoder and decoder are written for this one,
+        // so another descriptor means a second layout to go with it, not just new numbers here.
+        typedef FrigidaireProtocol ActiveProtocol;
+    }
+}
@@ -0,0 +1,155 @@
+// Encode/decode throughput of FrigidareClimate on the host.
+// Walks every mode/fan/swing/temperature combination through transmit_state() and on_receive(),
+// and times traits(), which the API calls constantly.
+//
+//   frigidaire_codec_bench [rounds]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "loopback_climate.h"
+
+using namespace esphome;
+
+namespace {
+    struct State {
+        climate::ClimateMode mode;
+        climate::ClimateFanMode fan;
+        climate::ClimateSwingMode swing;
+        float temperature;
+    };
+
+    std::vector<State> allStates() {
+        const climate::ClimateMode modes[] = {
+            climate::CLIMATE_MODE_OFF,
+            climate::CLIMATE_MODE_AUTO,
+            climate::CLIMATE_MODE_COOL,
+            climate::CLIMATE_MODE_DRY,
+            climate::CLIMATE_MODE_FAN_ONLY
+        };
+        const climate::ClimateFanMode fans[] = {
+            climate::CLIMATE_FAN_AUTO,
+            climate::CLIMATE_FAN_LOW,
+            climate::CLIMATE_FAN_MEDIUM,
+            climate::CLIMATE_FAN_HIGH
+        };
+        const climate::ClimateSwingMode swings[] = {
+            climate::CLIMATE_SWING_OFF,
+            climate::CLIMATE_SWING_VERTICAL
+        };
+
+        std::vector<State> states;
+        for (auto mode : modes) {
+            for (auto fan : fans) {
+                for (auto swing : swings) {
+                    for (int temperature = frigidaire::FRIGIDAIRE_TEMP_C_MIN; temperature <= frigidaire::FRIGIDAIRE_TEMP_C_MAX; temperature += 1) {
+                        states.push_back({mode, fan, swing, static_cast<float>(temperature)});
+                    }
+                }
+            }
+        }
+        return states;
+    }
+
+    void apply(host::LoopbackClimate &climate, const State &state) {
+        climate.mode = state.mode;
+        climate.fan_mode = state.fan;
+        climate.swing_mode = state.swing;
+        climate.target_temperature = state.temperature;
+    }
+
+    // An NEC frame, what most TV remotes send. It shares our header timing.
+    std::vector<int32_t> necBurst(uint32_t code) {
+        std::vector<int32_t> burst = {9000, -4500};
+        for (uint8_t bit = 0; bit < 32; bit += 1) {
+            burst.push_back(560);
+            burst.push_back(((code >> bit) & 0x01) != 0 ? -1690 : -560);
+        }
+        burst.push_back(560);
+        return burst;
+    }
+
+    void report(const char *name, size_t frames, std::chrono::nanoseconds elapsed) {
+        double ns = static_cast<double>(elapsed.count());
+        std::printf("%-8s frames=%zu ns/frame=%.1f frames/s=%.0f\n", name, frames, ns / frames, frames * 1e9 / ns);
+    }
+}
+
+int main(int argc, char **argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    // Logging goes to stderr on the host, keep it from dominating the numbers.
+    host::log_level = ESPHOME_LOG_LEVEL_NONE;
+
+    remote_transmitter::RemoteTransmitterComponent transmitter;
+    host::LoopbackClimate climate;
+    climate.set_loopback(&transmitter);
+    climate.setup();
+
+    const std::vector<State> states = allStates();
+
+    // Capture one burst per state to feed the decoder.
+    std::vector<std::vector<int32_t>> bursts;
+    bursts.reserve(states.size());
+    for (const State &state : states) {
+        apply(climate, state);
+        climate.transmit_state();
+        bursts.push_back(transmitter.get_last_data().get_data());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round += 1) {
+        for (const State &state : states) {
+            apply(climate, state);
+            climate.transmit_state();
+        }
+    }
+    report("encode", states.size() * rounds, std::chrono::steady_clock::now() - start);
+
+    size_t accepted = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round += 1) {
+        for (std::vector<int32_t> &burst : bursts) {
+            accepted += climate.on_receive(remote_base::RemoteReceiveData(&burst, 25)) ? 1 : 0;
+        }
+    }
+    report("decode", bursts.size() * rounds, std::chrono::steady_clock::now() - start);
+
+    std::vector<int32_t> foreign = necBurst(0x20DF10EF);
+    size_t falseAccepts = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round += 1) {
+        for (size_t frame = 0; frame < bursts.size(); frame += 1) {
+            falseAccepts += climate.on_receive(remote_base::RemoteReceiveData(&foreign, 25)) ? 1 : 0;
+        }
+    }
+    report("reject", bursts.size() * rounds, std::chrono::steady_clock::now() - start);
+
+    // The API asks for the traits every time it describes or validates this climate.
+    size_t modes = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; round += 1) {
+        for (size_t frame = 0; frame < bursts.size(); frame += 1) {
+            modes += climate.get_traits().get_supported_modes().size();
+        }
+    }
+    report("traits", bursts.size() * rounds, std::chrono::steady_clock::now() - start);
+
+    if (modes == 0) {
+        std::fprintf(stderr, "no supported modes\n");
+        return 1;
+    }
+
+    if (falseAccepts != 0) {
+        std::fprintf(stderr, "decoder accepted %zu foreign frames\n", falseAccepts);
+        return 1;
+    }
+
+    if (accepted != bursts.size() * rounds) {
+        std::fprintf(stderr, "decoder rejected %zu of %zu frames\n", bursts.size() * rounds - accepted, bursts.size() * rounds);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// The setup the bench and replay tools share: one climate whose own frames are fed straight back into it.
+
+#include "frigidaire.h"
+
+namespace esphome {
+    namespace host {
+        // Exposes the protected codec entry points.
+        class LoopbackClimate : public frigidaire::FrigidareClimate {
+            public:
+                using frigidaire::FrigidareClimate::transmit_state;
+                using frigidaire::FrigidareClimate::on_receive;
+
+                // Every call goes through the whole encoder as its own frame, straight away.
+                // The frames decoded afterwards were all just sent by this same climate, and shouldn't be taken for echoes.
+                // Anything else, calibration included, is still up to the caller before setup().
+                void set_loopback(remote_transmitter::RemoteTransmitterComponent * transmitter) {
+                    this->set_transmitter(transmitter);
+                    this->set_suppress_duplicates(false);
+                    this->set_transmit_coalesce_window(0);
+                    this->set_echo_window(0);
+                }
+        };
+    }
+}
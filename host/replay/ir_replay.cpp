@@ -0,0 +1,311 @@
+// Replays captured IR through FrigidareClimate's decoder, along with mutated copies of every frame.
+// Reports throughput, and how often a damaged frame was accepted as a different state than it started as.
+//
+//   frigidaire_ir_replay [--mutations N] [--seed S] [--calibrate N] [capture files...]
+//
+// Capture files are either ESPHome logs from a node with `capture: true`
+// ("capture <frame> <offset>: <timings>" lines), or one frame per line of timings.
+// Without any files, every state the encoder can produce is used instead.
+// --calibrate feeds the first N frames through timing calibration before anything is measured.
+// Synthesized frames have no spread at all, so calibrating on them only shows what overly tight windows cost.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "loopback_climate.h"
+
+using namespace esphome;
+
+namespace {
+    typedef std::vector<int32_t> Timings;
+
+    // The climate state a frame leaves behind.
+    struct State {
+        climate::ClimateMode mode;
+        optional<climate::ClimateFanMode> fan;
+        climate::ClimateSwingMode swing;
+        float temperature;
+
+        bool operator==(const State & other) const {
+            return this->mode == other.mode && this->fan == other.fan && this->swing == other.swing && this->temperature == other.temperature;
+        }
+    };
+
+    struct Result {
+        bool accepted;
+        State state;
+    };
+
+    // Puts the climate in a state no frame decodes to, so anything a frame changes shows up.
+    // Frames only carry whole degrees, and a powered off one still encodes the target, so it has to be a valid one.
+    const float UNTOUCHED_TEMPERATURE = 20.5f;
+
+    Result replay(host::LoopbackClimate & climate, Timings & timings) {
+        climate.mode = climate::CLIMATE_MODE_HEAT_COOL;
+        climate.fan_mode = climate::CLIMATE_FAN_FOCUS;
+        climate.swing_mode = climate::CLIMATE_SWING_BOTH;
+        climate.target_temperature = UNTOUCHED_TEMPERATURE;
+
+        bool accepted = climate.on_receive(remote_base::RemoteReceiveData(&timings, 25));
+        return {accepted, {climate.mode, climate.fan_mode, climate.swing_mode, climate.target_temperature}};
+    }
+
+    void parseTimings(std::istream & stream, Timings & timings) {
+        std::string token;
+        while (stream >> token) {
+            char * end = nullptr;
+            long value = std::strtol(token.c_str(), &end, 10);
+            if (end != token.c_str()) {
+                timings.push_back(static_cast<int32_t>(value));
+            }
+        }
+    }
+
+    void loadCapture(const char * path, std::vector<Timings> & frames) {
+        std::ifstream file(path);
+        if (!file) {
+            std::fprintf(stderr, "can't open %s\n", path);
+            std::exit(2);
+        }
+
+        // Frames logged by the node, by frame number, until their "end" line shows up.
+        std::map<unsigned, Timings> pending;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            for (char & c : line) {
+                if (c == ',') {
+                    c = ' ';
+                }
+            }
+
+            size_t at = line.find("capture ");
+            if (at != std::string::npos) {
+                std::istringstream stream(line.substr(at + 8));
+                unsigned frame = 0;
+                std::string where;
+                if (!(stream >> frame >> where)) {
+                    continue;
+                }
+
+                if (where == "end") {
+                    if (!pending[frame].empty()) {
+                        frames.push_back(pending[frame]);
+                    }
+                    pending.erase(frame);
+                } else {
+                    // Frame numbers start over when the node reboots.
+                    if (std::strtoul(where.c_str(), nullptr, 10) == 0) {
+                        pending[frame].clear();
+                    }
+                    parseTimings(stream, pending[frame]);
+                }
+            } else if (!line.empty() && line[0] != '#') {
+                std::istringstream stream(line);
+                Timings timings;
+                parseTimings(stream, timings);
+                if (!timings.empty()) {
+                    frames.push_back(timings);
+                }
+            }
+        }
+    }
+
+    void synthesize(host::LoopbackClimate & climate, remote_transmitter::RemoteTransmitterComponent & transmitter, std::vector<Timings> & frames) {
+        const climate::ClimateMode modes[] = {climate::CLIMATE_MODE_OFF, climate::CLIMATE_MODE_AUTO, climate::CLIMATE_MODE_COOL, climate::CLIMATE_MODE_DRY, climate::CLIMATE_MODE_FAN_ONLY};
+        const climate::ClimateFanMode fans[] = {climate::CLIMATE_FAN_AUTO, climate::CLIMATE_FAN_LOW, climate::CLIMATE_FAN_MEDIUM, climate::CLIMATE_FAN_HIGH};
+        const climate::ClimateSwingMode swings[] = {climate::CLIMATE_SWING_OFF, climate::CLIMATE_SWING_VERTICAL};
+
+        for (auto mode : modes) {
+            for (auto fan : fans) {
+                for (auto swing : swings) {
+                    for (int temperature = frigidaire::FRIGIDAIRE_TEMP_C_MIN; temperature <= frigidaire::FRIGIDAIRE_TEMP_C_MAX; temperature += 1) {
+                        climate.mode = mode;
+                        climate.fan_mode = fan;
+                        climate.swing_mode = swing;
+                        climate.target_temperature = temperature;
+                        climate.transmit_state();
+
+                        // A real receiver never sees the trailing gap, it's what ends the capture.
+                        Timings timings = transmitter.get_last_data().get_data();
+                        timings.pop_back();
+                        frames.push_back(timings);
+                    }
+                }
+            }
+        }
+    }
+
+    enum Mutation {
+        JITTER,
+        BIT_FLIP,
+        DOUBLE_BIT_FLIP,
+        TRUNCATE,
+        DROP_PULSE,
+        GLITCH,
+        MUTATION_COUNT
+    };
+
+    const char * const MUTATION_NAMES[MUTATION_COUNT] = {"jitter", "bit flip", "2 bit flips", "truncate", "drop pulse", "glitch"};
+
+    // Turns the space after a data bit mark into the other kind of bit.
+    void flipBit(Timings & timings, std::mt19937 & random) {
+        if (timings.size() < 4) {
+            return;
+        }
+        const size_t pairs = (timings.size() - 2) / 2;
+        const size_t space = 2 + 2 * std::uniform_int_distribution<size_t>(0, pairs - 1)(random) + 1;
+        timings[space] = -timings[space] > 1000 ? -500 : -1650;
+    }
+
+    void mutate(Mutation mutation, Timings & timings, std::mt19937 & random) {
+        switch (mutation) {
+            case JITTER: {
+                // Wide enough to push some pulses past the receiver's tolerance.
+                std::normal_distribution<float> jitter(1.0f, 0.07f);
+                for (int32_t & timing : timings) {
+                    timing = static_cast<int32_t>(std::lround(timing * jitter(random)));
+                }
+                break;
+            }
+            case BIT_FLIP:
+                flipBit(timings, random);
+                break;
+            case DOUBLE_BIT_FLIP:
+                flipBit(timings, random);
+                flipBit(timings, random);
+                break;
+            case TRUNCATE:
+                timings.resize(std::uniform_int_distribution<size_t>(0, timings.size())(random));
+                break;
+            case DROP_PULSE:
+                if (!timings.empty()) {
+                    timings.erase(timings.begin() + std::uniform_int_distribution<size_t>(0, timings.size() - 1)(random));
+                }
+                break;
+            case GLITCH: {
+                // A short flash of light in the middle of a space, from a lamp or another remote.
+                if (timings.size() < 2) {
+                    break;
+                }
+                const size_t space = 1 + 2 * std::uniform_int_distribution<size_t>(0, (timings.size() - 2) / 2)(random);
+                const int32_t length = timings[space];
+                const int32_t before = length / 2;
+                timings[space] = before;
+                timings.insert(timings.begin() + space + 1, {std::uniform_int_distribution<int32_t>(50, 700)(random), length - before - 1});
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+int main(int argc, char ** argv) {
+    uint32_t mutations = 1000000;
+    uint32_t seed = 1;
+    uint16_t calibrate = 0;
+    std::vector<const char *> paths;
+
+    for (int arg = 1; arg < argc; arg += 1) {
+        if (std::strcmp(argv[arg], "--mutations") == 0 && arg + 1 < argc) {
+            mutations = std::strtoul(argv[++arg], nullptr, 10);
+        } else if (std::strcmp(argv[arg], "--seed") == 0 && arg + 1 < argc) {
+            seed = std::strtoul(argv[++arg], nullptr, 10);
+        } else if (std::strcmp(argv[arg], "--calibrate") == 0 && arg + 1 < argc) {
+            calibrate = std::strtoul(argv[++arg], nullptr, 10);
+        } else {
+            paths.push_back(argv[arg]);
+        }
+    }
+
+    host::log_level = ESPHOME_LOG_LEVEL_NONE;
+
+    remote_transmitter::RemoteTransmitterComponent transmitter;
+    host::LoopbackClimate climate;
+    climate.set_loopback(&transmitter);
+    climate.set_calibration_frames(calibrate);
+    climate.setup();
+
+    std::vector<Timings> frames;
+    for (const char * path : paths) {
+        loadCapture(path, frames);
+    }
+    if (paths.empty()) {
+        synthesize(climate, transmitter, frames);
+    }
+    if (frames.empty()) {
+        std::fprintf(stderr, "no frames to replay\n");
+        return 2;
+    }
+
+    for (uint16_t frame = 0; frame < calibrate; frame += 1) {
+        Timings copy = frames[frame % frames.size()];
+        replay(climate, copy);
+    }
+
+    // What every frame decodes to untouched, the reference for its mutations.
+    std::vector<Result> originals;
+    size_t originalsAccepted = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (Timings & frame : frames) {
+        Timings copy = frame;
+        originals.push_back(replay(climate, copy));
+        originalsAccepted += originals.back().accepted ? 1 : 0;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("captured   frames=%zu accepted=%zu frames/s=%.0f\n", frames.size(), originalsAccepted, frames.size() / elapsed);
+
+    std::mt19937 random(seed);
+    uint64_t counts[MUTATION_COUNT] = {};
+    uint64_t accepted[MUTATION_COUNT] = {};
+    uint64_t falseAccepts[MUTATION_COUNT] = {};
+    double decodeSeconds = 0;
+
+    Timings mutated;
+    for (uint32_t iteration = 0; iteration < mutations; iteration += 1) {
+        const size_t frame = std::uniform_int_distribution<size_t>(0, frames.size() - 1)(random);
+        const Mutation mutation = static_cast<Mutation>(iteration % MUTATION_COUNT);
+
+        mutated = frames[frame];
+        mutate(mutation, mutated, random);
+
+        start = std::chrono::steady_clock::now();
+        const Result result = replay(climate, mutated);
+        decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        counts[mutation] += 1;
+        if (result.accepted) {
+            accepted[mutation] += 1;
+            // Accepting a damaged frame is fine as long as it still says what the original did.
+            if (!originals[frame].accepted || !(result.state == originals[frame].state)) {
+                falseAccepts[mutation] += 1;
+            }
+        }
+    }
+
+    uint64_t totalFalseAccepts = 0;
+    for (size_t mutation = 0; mutation < MUTATION_COUNT; mutation += 1) {
+        std::printf("%-12s frames=%llu accepted=%llu false_accepts=%llu false_accept_rate=%.6f\n",
+            MUTATION_NAMES[mutation],
+            static_cast<unsigned long long>(counts[mutation]),
+            static_cast<unsigned long long>(accepted[mutation]),
+            static_cast<unsigned long long>(falseAccepts[mutation]),
+            counts[mutation] != 0 ? static_cast<double>(falseAccepts[mutation]) / counts[mutation] : 0.0);
+        totalFalseAccepts += falseAccepts[mutation];
+    }
+
+    std::printf("mutated    frames=%u frames/s=%.0f ns/frame=%.1f false_accept_rate=%.6f\n",
+        mutations, mutations / decodeSeconds, decodeSeconds * 1e9 / mutations,
+        mutations != 0 ? static_cast<double>(totalFalseAccepts) / mutations : 0.0);
+
+    return 0;
+}
@@ -0,0 +1,502 @@
+// Deterministic end to end simulation of FrigidareClimate under load.
+// Commands go in through ClimateCalls, frames go out through a loopback IR channel that the node's own receiver
+// and a simulated remote share, and everything runs off the simulated clock, so every run of a commit prints the same report.
+//
+//   frigidaire_latency_sim [workload...]
+//
+// Per workload it reports:
+//   command_to_ir  milliseconds from a ClimateCall to the first frame carrying what it asked for
+//   airtime        time the LED spent on, in total and per command
+//   decode_to_pub  milliseconds from a remote frame reaching the receiver to the state being published
+// Commands a later one overrode before anything went out count as coalesced, and ones the unit was already doing as no-ops.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+#include "frigidaire.h"
+
+using namespace esphome;
+
+namespace {
+    // remote_receiver's default idle, the silence that ends a buffer.
+    const uint32_t RECEIVER_IDLE_US = 10000;
+
+    // climate.py's default persist_delay.
+    const uint32_t PERSIST_DELAY_MS = 30000;
+
+    typedef std::vector<int32_t> Timings;
+
+    // What a ClimateCall asked for, and what became of it.
+    struct Command {
+        uint32_t issued;
+        optional<climate::ClimateMode> mode;
+        optional<float> temperature;
+        optional<climate::ClimateFanMode> fan;
+        optional<climate::ClimateSwingMode> swing;
+        bool resolved;
+
+        // Whether a frame on the air does what this command asked.
+        bool satisfiedBy(const frigidaire::Payload & payload) const {
+            if (this->mode.has_value()) {
+                switch (*this->mode) {
+                    case climate::CLIMATE_MODE_OFF:
+                        if (payload.isPowered()) return false;
+                        break;
+                    case climate::CLIMATE_MODE_COOL:
+                        if (!payload.isPowered() || payload.getMode() != frigidaire::Mode::COOL) return false;
+                        break;
+                    case climate::CLIMATE_MODE_DRY:
+                        if (!payload.isPowered() || payload.getMode() != frigidaire::Mode::DRY) return false;
+                        break;
+                    case climate::CLIMATE_MODE_FAN_ONLY:
+                        if (!payload.isPowered() || payload.getMode() != frigidaire::Mode::FAN) return false;
+                        break;
+                    default:
+                        if (!payload.isPowered() || payload.getMode() != frigidaire::Mode::MODE_AUTO) return false;
+                        break;
+                }
+            }
+            if (this->temperature.has_value() && payload.getTempratureC() != static_cast<uint8_t>(*this->temperature)) {
+                return false;
+            }
+            if (this->fan.has_value()) {
+                const frigidaire::FanSpeed expected =
+                    *this->fan == climate::CLIMATE_FAN_HIGH ? frigidaire::FanSpeed::FAN_HIGH :
+                    *this->fan == climate::CLIMATE_FAN_MEDIUM ? frigidaire::FanSpeed::FAN_MID :
+                    *this->fan == climate::CLIMATE_FAN_LOW ? frigidaire::FanSpeed::FAN_LOW : frigidaire::FanSpeed::FAN_AUTO;
+                if (payload.getFanSpeed() != expected) {
+                    return false;
+                }
+            }
+            if (this->swing.has_value() &&
+                payload.getSwingMode() != (*this->swing == climate::CLIMATE_SWING_VERTICAL ? frigidaire::SwingMode::SWING_ON : frigidaire::SwingMode::SWING_OFF)) {
+                return false;
+            }
+            return true;
+        }
+
+        // Every field this sets, a later command sets too.
+        bool supersededBy(const Command & later) const {
+            return (!this->mode.has_value() || later.mode.has_value()) &&
+                (!this->temperature.has_value() || later.temperature.has_value()) &&
+                (!this->fan.has_value() || later.fan.has_value()) &&
+                (!this->swing.has_value() || later.swing.has_value());
+        }
+    };
+
+    // One buffer's worth of light on its way to the receiver.
+    struct Delivery {
+        uint64_t startUs;
+        uint64_t endUs;
+        Timings timings;
+        bool fromRemote;
+    };
+
+    struct Stats {
+        std::vector<uint32_t> commandToIr;
+        std::vector<uint32_t> decodeToPublish;
+        uint32_t commands = 0;
+        uint32_t coalesced = 0;
+        uint32_t noops = 0;
+        uint32_t unsent = 0;
+        uint32_t frames = 0;
+        uint64_t airtimeUs = 0;
+        uint32_t remoteFrames = 0;
+        uint32_t unpublished = 0;
+        uint32_t collisions = 0;
+        uint32_t flashWrites = 0;
+    };
+
+    class SimClimate : public frigidaire::FrigidareClimate {
+        public:
+            using frigidaire::FrigidareClimate::on_receive;
+    };
+
+    class Simulation {
+        public:
+            Simulation() {
+                // What decides whether a frame on the air satisfies a command. Always nominal, whatever the node is doing.
+                for (size_t kind = 0; kind < frigidaire::PULSE_KIND_COUNT; kind += 1) {
+                    const uint16_t nominal[] = {
+                        frigidaire::ActiveProtocol::HEADER_MARK, frigidaire::ActiveProtocol::HEADER_SPACE, frigidaire::ActiveProtocol::BIT_MARK,
+                        frigidaire::ActiveProtocol::ONE_SPACE, frigidaire::ActiveProtocol::ZERO_SPACE
+                    };
+                    this->windows[kind] = frigidaire::PulseWindow::around(nominal[kind], 25);
+                }
+
+                global_preferences->reset();
+                this->flashWritesAtStart = ESPPreferenceObject::save_count;
+                this->start = millis();
+
+                // The node, configured the way climate.py does by default.
+                this->node.set_transmitter(&this->nodeTransmitter);
+                this->node.set_transmit_coalesce_window(250);
+                this->node.set_echo_window(500);
+                this->node.set_persist_delay(PERSIST_DELAY_MS);
+                this->receiver.register_listener(&this->node);
+                this->nodeTransmitter.set_sink([this](const remote_base::RemoteTransmitData & data, uint32_t sendTimes, uint32_t sendWait) {
+                    this->onAir(data.get_data(), sendTimes, sendWait, false);
+                });
+
+                // The remote is just another climate that sends every press straight away.
+                this->remote.set_transmitter(&this->remoteTransmitter);
+                this->remote.set_transmit_coalesce_window(0);
+                this->remote.set_suppress_duplicates(false);
+                this->remote.set_persist_payload(false);
+                this->remoteTransmitter.set_sink([this](const remote_base::RemoteTransmitData & data, uint32_t sendTimes, uint32_t sendWait) {
+                    this->onAir(data.get_data(), sendTimes, sendWait, true);
+                });
+            }
+
+            SimClimate & getNode() {
+                return this->node;
+            }
+
+            void setup() {
+                this->node.setup();
+                this->remote.setup();
+                this->publishes = this->node.get_publish_count();
+            }
+
+            // Something Home Assistant or an automation asked for.
+            void command(const Command & asked) {
+                Command command = asked;
+                command.issued = this->now();
+                command.resolved = false;
+                this->stats.commands += 1;
+
+                // Asking for what's already on the air is for the duplicate suppression to deal with, not a latency.
+                if (this->lastFrameValid && command.satisfiedBy(frigidaire::Payload::unpack(this->lastFrame))) {
+                    this->stats.noops += 1;
+                    command.resolved = true;
+                }
+
+                for (Command & pending : this->commands) {
+                    if (!pending.resolved && pending.supersededBy(command)) {
+                        pending.resolved = true;
+                        this->stats.coalesced += 1;
+                    }
+                }
+                this->commands.push_back(command);
+
+                climate::ClimateCall call = this->node.make_call();
+                if (command.mode.has_value()) call.set_mode(*command.mode);
+                if (command.temperature.has_value()) call.set_target_temperature(*command.temperature);
+                if (command.fan.has_value()) call.set_fan_mode(*command.fan);
+                if (command.swing.has_value()) call.set_swing_mode(*command.swing);
+                call.perform();
+
+                // control() publishes the new state itself, and that's not a decode.
+                this->publishes = this->node.get_publish_count();
+            }
+
+            // Somebody pressing a button on the physical remote.
+            void press(climate::ClimateMode mode, float temperature, climate::ClimateFanMode fan) {
+                this->remote.mode = mode;
+                this->remote.target_temperature = temperature;
+                this->remote.fan_mode = fan;
+                this->remote.make_call().perform();
+            }
+
+            // Runs the clock one millisecond at a time up to the given point in the workload.
+            void runUntil(uint32_t until) {
+                while (this->now() < until) {
+                    host::advance(1);
+                    this->pollPublishes();
+                    this->deliver();
+                    this->pollPublishes();
+                }
+            }
+
+            Stats finish() {
+                for (const Command & command : this->commands) {
+                    if (!command.resolved) {
+                        this->stats.unsent += 1;
+                    }
+                }
+                this->stats.unpublished += this->pendingDecodes.size();
+
+                // The last change of a workload is still waiting on the persist timeout, and it's going to be
+                // written whether or not anything else happens, so let it fire before counting.
+                host::advance(PERSIST_DELAY_MS);
+                this->stats.flashWrites = ESPPreferenceObject::save_count - this->flashWritesAtStart;
+                return this->stats;
+            }
+
+        private:
+            uint32_t now() const {
+                return millis() - this->start;
+            }
+
+            void onAir(const Timings & timings, uint32_t sendTimes, uint32_t sendWait, bool fromRemote) {
+                uint64_t frameUs = 0;
+                for (int32_t timing : timings) {
+                    frameUs += std::abs(timing);
+                }
+
+                // The receiver only splits repeats into separate buffers if it sees its idle between them.
+                const uint64_t startUs = static_cast<uint64_t>(this->now()) * 1000;
+                const bool merged = static_cast<uint32_t>(std::abs(timings.back())) + sendWait < RECEIVER_IDLE_US;
+                uint64_t cursor = startUs;
+                Timings buffer;
+                for (uint32_t send = 0; send < sendTimes; send += 1) {
+                    buffer.insert(buffer.end(), timings.begin(), timings.end());
+                    if (send + 1 < sendTimes) {
+                        cursor += frameUs + sendWait;
+                        if (merged) {
+                            continue;
+                        }
+                    } else {
+                        cursor += frameUs;
+                    }
+                    this->deliveries.push_back({startUs, cursor, buffer, fromRemote});
+                    buffer.clear();
+                }
+
+                const uint64_t airtime = frameUs * sendTimes + static_cast<uint64_t>(sendWait) * (sendTimes - 1);
+                if (fromRemote) {
+                    this->stats.remoteFrames += 1;
+                    return;
+                }
+
+                this->stats.frames += 1;
+                this->stats.airtimeUs += airtime;
+
+                if (frigidaire::decodeFrame(timings, this->windows, this->lastFrame) != frigidaire::FRAME_ACCEPTED) {
+                    return;
+                }
+                this->lastFrameValid = true;
+
+                const frigidaire::Payload payload = frigidaire::Payload::unpack(this->lastFrame);
+                for (Command & command : this->commands) {
+                    if (!command.resolved && command.satisfiedBy(payload)) {
+                        command.resolved = true;
+                        this->stats.commandToIr.push_back(this->now() - command.issued);
+                    }
+                }
+            }
+
+            // Hands over every buffer whose idle has run out. Light from both ends at once is garbage to the receiver.
+            void deliver() {
+                const uint64_t nowUs = static_cast<uint64_t>(this->now()) * 1000;
+                while (!this->deliveries.empty() && this->deliveries.front().endUs + RECEIVER_IDLE_US <= nowUs) {
+                    Delivery delivery = std::move(this->deliveries.front());
+                    this->deliveries.pop_front();
+
+                    bool collided = false;
+                    for (const Delivery & other : this->deliveries) {
+                        collided |= other.fromRemote != delivery.fromRemote && other.startUs < delivery.endUs && delivery.startUs < other.endUs;
+                    }
+                    for (const Delivery & other : this->recent) {
+                        collided |= other.fromRemote != delivery.fromRemote && other.startUs < delivery.endUs && delivery.startUs < other.endUs;
+                    }
+                    this->recent.push_back({delivery.startUs, delivery.endUs, {}, delivery.fromRemote});
+                    if (this->recent.size() > 8) {
+                        this->recent.pop_front();
+                    }
+
+                    if (collided) {
+                        this->stats.collisions += 1;
+                        continue;
+                    }
+
+                    const uint32_t before = this->node.get_publish_count();
+                    this->receiver.receive(delivery.timings);
+                    if (delivery.fromRemote) {
+                        if (this->node.get_publish_count() != before) {
+                            // Whatever was still waiting got overtaken by this one.
+                            this->stats.unpublished += this->pendingDecodes.size();
+                            this->pendingDecodes.clear();
+                            this->stats.decodeToPublish.push_back(0);
+                            this->publishes = this->node.get_publish_count();
+                        } else {
+                            this->pendingDecodes.push_back(this->now());
+                        }
+                    }
+                }
+            }
+
+            // Publishes that happen later, from min_publish_interval.
+            void pollPublishes() {
+                if (this->node.get_publish_count() == this->publishes) {
+                    return;
+                }
+                this->publishes = this->node.get_publish_count();
+                for (uint32_t decoded : this->pendingDecodes) {
+                    this->stats.decodeToPublish.push_back(this->now() - decoded);
+                }
+                this->pendingDecodes.clear();
+            }
+
+            SimClimate node;
+            SimClimate remote;
+            remote_transmitter::RemoteTransmitterComponent nodeTransmitter;
+            remote_transmitter::RemoteTransmitterComponent remoteTransmitter;
+            remote_base::RemoteReceiverBase receiver;
+
+            frigidaire::PulseWindows windows;
+            uint32_t start;
+            uint32_t flashWritesAtStart;
+            uint32_t publishes = 0;
+
+            std::deque<Delivery> deliveries;
+            std::deque<Delivery> recent;
+            std::vector<Command> commands;
+            std::vector<uint32_t> pendingDecodes;
+            frigidaire::Frame lastFrame {};
+            bool lastFrameValid = false;
+
+            Stats stats;
+    };
+
+    Command setTemperature(float temperature) {
+        Command command {};
+        command.temperature = temperature;
+        return command;
+    }
+
+    Command setMode(climate::ClimateMode mode) {
+        Command command {};
+        command.mode = mode;
+        return command;
+    }
+
+    Command setFan(climate::ClimateFanMode fan) {
+        Command command {};
+        command.fan = fan;
+        return command;
+    }
+
+    Command setSwing(climate::ClimateSwingMode swing) {
+        Command command {};
+        command.swing = swing;
+        return command;
+    }
+
+    // Dragging the temperature slider in Home Assistant: a call every 50ms on the way, then letting go.
+    void sliderDrag(Simulation & sim) {
+        sim.command(setMode(climate::CLIMATE_MODE_COOL));
+        uint32_t at = 2000;
+        for (int drag = 0; drag < 10; drag += 1) {
+            const bool up = drag % 2 == 0;
+            for (int step = 0; step <= 14; step += 1) {
+                sim.runUntil(at);
+                sim.command(setTemperature(up ? 16 + step : 30 - step));
+                at += 50;
+            }
+            at += 3000;
+        }
+        sim.runUntil(at + 5000);
+    }
+
+    // An automation setting everything one call at a time, every few seconds, half the time to what it already is.
+    void automationBurst(Simulation & sim) {
+        uint32_t at = 0;
+        for (int burst = 0; burst < 30; burst += 1) {
+            sim.runUntil(at);
+            const bool warm = (burst / 2) % 2 == 0;
+            sim.command(setMode(climate::CLIMATE_MODE_COOL));
+            sim.command(setTemperature(warm ? 26 : 22));
+            sim.command(setFan(warm ? climate::CLIMATE_FAN_LOW : climate::CLIMATE_FAN_HIGH));
+            sim.command(setSwing(climate::CLIMATE_SWING_OFF));
+            at += 2000;
+        }
+        sim.runUntil(at + 5000);
+    }
+
+    // Somebody holding the temperature button down on the physical remote.
+    void remoteSpam(Simulation & sim) {
+        uint32_t at = 0;
+        for (int press = 0; press < 100; press += 1) {
+            sim.runUntil(at);
+            const int offset = press % 20;
+            sim.press(climate::CLIMATE_MODE_COOL, 16 + (offset < 10 ? offset : 20 - offset), climate::CLIMATE_FAN_AUTO);
+            at += 250;
+        }
+        sim.runUntil(at + 5000);
+    }
+
+    // The same, with the node holding publishes back to one a second.
+    void remoteSpamThrottled(Simulation & sim) {
+        sim.getNode().set_min_publish_interval(1000);
+        remoteSpam(sim);
+    }
+
+    // An automation and somebody with the remote fighting over the unit.
+    void tugOfWar(Simulation & sim) {
+        uint32_t at = 0;
+        for (int round = 0; round < 40; round += 1) {
+            sim.runUntil(at);
+            sim.command(setTemperature(round % 2 == 0 ? 24 : 25));
+            sim.runUntil(at + 500);
+            sim.press(climate::CLIMATE_MODE_COOL, 20, climate::CLIMATE_FAN_HIGH);
+            at += 700;
+        }
+        sim.runUntil(at + 5000);
+    }
+
+    struct Workload {
+        const char * name;
+        void (*run)(Simulation &);
+    };
+
+    std::string summarize(std::vector<uint32_t> samples) {
+        if (samples.empty()) {
+            return "n=0";
+        }
+        std::sort(samples.begin(), samples.end());
+        uint64_t total = 0;
+        for (uint32_t sample : samples) {
+            total += sample;
+        }
+
+        char line[96];
+        std::snprintf(line, sizeof(line), "n=%zu avg=%.1f p95=%u max=%u", samples.size(),
+            static_cast<double>(total) / samples.size(), samples[(samples.size() - 1) * 95 / 100], samples.back());
+        return line;
+    }
+
+    void report(const char * name, const Stats & stats) {
+        std::printf("%s\n", name);
+        std::printf("  commands=%u coalesced=%u noops=%u unsent=%u\n", stats.commands, stats.coalesced, stats.noops, stats.unsent);
+        std::printf("  command_to_ir_ms %s\n", summarize(stats.commandToIr).c_str());
+        std::printf("  frames=%u airtime_ms=%.1f airtime_per_command_ms=%.1f\n", stats.frames, stats.airtimeUs / 1000.0,
+            stats.commands != 0 ? stats.airtimeUs / 1000.0 / stats.commands : 0.0);
+        std::printf("  remote_frames=%u collisions=%u unpublished=%u\n", stats.remoteFrames, stats.collisions, stats.unpublished);
+        std::printf("  decode_to_pub_ms %s\n", summarize(stats.decodeToPublish).c_str());
+        std::printf("  flash_writes=%u\n", stats.flashWrites);
+    }
+}
+
+int main(int argc, char ** argv) {
+    host::log_level = ESPHOME_LOG_LEVEL_NONE;
+
+    const Workload workloads[] = {
+        {"slider_drag", sliderDrag},
+        {"automation_burst", automationBurst},
+        {"remote_spam", remoteSpam},
+        {"remote_spam_throttled", remoteSpamThrottled},
+        {"tug_of_war", tugOfWar},
+    };
+
+    for (const Workload & workload : workloads) {
+        bool selected = argc < 2;
+        for (int arg = 1; arg < argc; arg += 1) {
+            selected |= std::strcmp(argv[arg], workload.name) == 0;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        Simulation sim;
+        sim.setup();
+        workload.run(sim);
+        report(workload.name, sim.finish());
+    }
+
+    return 0;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Host stand-in for the generated esphome.h umbrella header.
+
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+#include "esphome/components/climate/climate.h"
+#include "esphome/components/climate_ir/climate_ir.h"
+#include "esphome/components/remote_base/remote_base.h"
+#include "esphome/components/remote_transmitter/remote_transmitter.h"
+#include "esphome/components/sensor/sensor.h"
+
+using namespace esphome;
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for esphome/components/button.
+
+namespace esphome {
+    namespace button {
+        class Button {
+            public:
+                virtual ~Button() = default;
+
+                void press() { this->press_action(); }
+
+            protected:
+                virtual void press_action() = 0;
+        };
+    }
+}
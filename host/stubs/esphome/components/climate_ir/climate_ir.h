@@ -0,0 +1,105 @@
+#pragma once
+
+// Host stand-in for esphome/components/climate_ir.
+// Mirrors the upstream ClimateIR: control() applies the call, transmits and publishes.
+
+#include <cmath>
+#include <set>
+#include "esphome/core/component.h"
+#include "esphome/components/climate/climate.h"
+#include "esphome/components/remote_base/remote_base.h"
+#include "esphome/components/remote_transmitter/remote_transmitter.h"
+#include "esphome/components/sensor/sensor.h"
+
+namespace esphome {
+    namespace climate_ir {
+        class ClimateIR : public climate::Climate, public Component, public remote_base::RemoteReceiverListener {
+            public:
+                ClimateIR(float minimum_temperature, float maximum_temperature, float temperature_step = 1.0f,
+                          bool supports_dry = false, bool supports_fan_only = false,
+                          std::set<climate::ClimateFanMode> fan_modes = {},
+                          std::set<climate::ClimateSwingMode> swing_modes = {},
+                          std::set<climate::ClimatePreset> presets = {})
+                    : minimum_temperature_(minimum_temperature),
+                      maximum_temperature_(maximum_temperature),
+                      temperature_step_(temperature_step),
+                      supports_dry_(supports_dry),
+                      supports_fan_only_(supports_fan_only),
+                      fan_modes_(std::move(fan_modes)),
+                      swing_modes_(std::move(swing_modes)),
+                      presets_(std::move(presets)) {}
+
+                void setup() override {
+                    if (this->sensor_ != nullptr) {
+                        this->sensor_->add_on_state_callback([this](float state) {
+                            this->current_temperature = state;
+                            this->publish_state();
+                        });
+                        this->current_temperature = this->sensor_->state;
+                    } else {
+                        this->current_temperature = NAN;
+                    }
+
+                    this->mode = climate::CLIMATE_MODE_OFF;
+                    this->target_temperature = roundf(clamp(this->current_temperature, this->minimum_temperature_, this->maximum_temperature_));
+                    this->fan_mode = climate::CLIMATE_FAN_AUTO;
+                    this->swing_mode = climate::CLIMATE_SWING_OFF;
+                    this->preset = climate::CLIMATE_PRESET_NONE;
+                    if (std::isnan(this->target_temperature)) {
+                        this->target_temperature = 24;
+                    }
+                }
+
+                void set_transmitter(remote_transmitter::RemoteTransmitterComponent *transmitter) { this->transmitter_ = transmitter; }
+                void set_supports_cool(bool supports_cool) { this->supports_cool_ = supports_cool; }
+                void set_supports_heat(bool supports_heat) { this->supports_heat_ = supports_heat; }
+                void set_sensor(sensor::Sensor *sensor) { this->sensor_ = sensor; }
+
+            protected:
+                float minimum_temperature_, maximum_temperature_, temperature_step_;
+
+                void control(const climate::ClimateCall &call) override {
+                    if (call.get_mode().has_value()) {
+                        this->mode = *call.get_mode();
+                    }
+                    if (call.get_target_temperature().has_value()) {
+                        this->target_temperature = *call.get_target_temperature();
+                    }
+                    if (call.get_fan_mode().has_value()) {
+                        this->fan_mode = *call.get_fan_mode();
+                    }
+                    if (call.get_swing_mode().has_value()) {
+                        this->swing_mode = *call.get_swing_mode();
+                    }
+                    if (call.get_preset().has_value()) {
+                        this->preset = *call.get_preset();
+                    }
+                    this->transmit_state();
+                    this->publish_state();
+                }
+
+                climate::ClimateTraits traits() override {
+                    climate::ClimateTraits traits;
+                    traits.set_visual_min_temperature(this->minimum_temperature_);
+                    traits.set_visual_max_temperature(this->maximum_temperature_);
+                    traits.set_visual_temperature_step(this->temperature_step_);
+                    return traits;
+                }
+
+                virtual void transmit_state() = 0;
+
+                bool on_receive(remote_base::RemoteReceiveData data) override { return false; }
+
+                bool supports_cool_{true};
+                bool supports_heat_{true};
+                bool supports_dry_{false};
+                bool supports_fan_only_{false};
+                std::set<climate::ClimateFanMode> fan_modes_ = {};
+                std::set<climate::ClimateSwingMode> swing_modes_ = {};
+                std::set<climate::ClimatePreset> presets_ = {};
+
+                remote_transmitter::RemoteTransmitterComponent *transmitter_{nullptr};
+                sensor::Sensor *sensor_{nullptr};
+        };
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+// Host stand-in for esphome/components/remote_base.
+// RemoteReceiveData and RemoteTransmitData behave like the upstream versions,
+// marks are positive durations and spaces negative, in microseconds.
+
+#include <cstdint>
+#include <vector>
+#include <functional>
+
+namespace esphome {
+    namespace remote_base {
+        class RemoteTransmitData {
+            public:
+                void mark(uint32_t length) { this->data_.push_back(length); }
+                void space(uint32_t length) { this->data_.push_back(-length); }
+                void item(uint32_t mark, uint32_t space) {
+                    this->mark(mark);
+                    this->space(space);
+                }
+                void reserve(uint32_t len) { this->data_.reserve(len); }
+                void set_carrier_frequency(uint32_t carrier_frequency) { this->carrier_frequency_ = carrier_frequency; }
+                uint32_t get_carrier_frequency() const { return this->carrier_frequency_; }
+                const std::vector<int32_t> &get_data() const { return this->data_; }
+                void set_data(const std::vector<int32_t> &data) {
+                    this->data_.clear();
+                    this->data_.reserve(data.size());
+                    for (int32_t i : data) {
+                        this->data_.push_back(i);
+                    }
+                }
+                void reset() {
+                    this->data_.clear();
+                    this->carrier_frequency_ = 0;
+                }
+
+            protected:
+                std::vector<int32_t> data_{};
+                uint32_t carrier_frequency_{0};
+        };
+
+        class RemoteReceiveData {
+            public:
+                RemoteReceiveData(std::vector<int32_t> *data, uint8_t tolerance)
+                    : data_(data), index_(0), tolerance_(tolerance) {}
+
+                bool peek_mark(uint32_t length, uint32_t offset = 0) {
+                    if (int32_t(this->index_ + offset) >= this->size()) {
+                        return false;
+                    }
+                    int32_t value = this->peek(offset);
+                    const int32_t lo = this->lower_bound_(length);
+                    const int32_t hi = this->upper_bound_(length);
+                    return value >= 0 && lo <= value && value <= hi;
+                }
+                bool peek_space(uint32_t length, uint32_t offset = 0) {
+                    if (int32_t(this->index_ + offset) >= this->size()) {
+                        return false;
+                    }
+                    int32_t value = this->peek(offset);
+                    const int32_t lo = this->lower_bound_(length);
+                    const int32_t hi = this->upper_bound_(length);
+                    return value <= 0 && lo <= -value && -value <= hi;
+                }
+                bool peek_item(uint32_t mark, uint32_t space, uint32_t offset = 0) {
+                    return this->peek_mark(mark, offset) && this->peek_space(space, offset + 1);
+                }
+                bool expect_mark(uint32_t length) {
+                    if (this->peek_mark(length)) {
+                        this->advance();
+                        return true;
+                    }
+                    return false;
+                }
+                bool expect_space(uint32_t length) {
+                    if (this->peek_space(length)) {
+                        this->advance();
+                        return true;
+                    }
+                    return false;
+                }
+                bool expect_item(uint32_t mark, uint32_t space) {
+                    if (this->peek_item(mark, space)) {
+                        this->advance(2);
+                        return true;
+                    }
+                    return false;
+                }
+
+                int32_t peek(uint32_t offset = 0) { return (*this)[this->index_ + offset]; }
+                void advance(uint32_t amount = 1) { this->index_ += amount; }
+                void reset() { this->index_ = 0; }
+                int32_t operator[](uint32_t index) const { return (*this->data_)[index]; }
+                int32_t size() const { return this->data_->size(); }
+                std::vector<int32_t> *get_raw_data() { return this->data_; }
+                uint32_t get_index() const { return this->index_; }
+
+            protected:
+                int32_t lower_bound_(uint32_t length) const { return int32_t(100 - this->tolerance_) * length / 100U; }
+                int32_t upper_bound_(uint32_t length) const { return int32_t(100 + this->tolerance_) * length / 100U; }
+
+                std::vector<int32_t> *data_;
+                uint32_t index_;
+                uint8_t tolerance_;
+        };
+
+        class RemoteReceiverListener {
+            public:
+                virtual ~RemoteReceiverListener() = default;
+                virtual bool on_receive(RemoteReceiveData data) = 0;
+        };
+
+        class RemoteReceiverBase {
+            public:
+                explicit RemoteReceiverBase(uint8_t tolerance = 25) : tolerance_(tolerance) {}
+
+                void register_listener(RemoteReceiverListener *listener) { this->listeners_.push_back(listener); }
+
+                // Host only: hand a captured timing buffer to every listener, like remote_receiver's loop() does.
+                bool receive(std::vector<int32_t> timings) {
+                    bool handled = false;
+                    for (RemoteReceiverListener *listener : this->listeners_) {
+                        handled |= listener->on_receive(RemoteReceiveData(&timings, this->tolerance_));
+                    }
+                    return handled;
+                }
+
+            protected:
+                std::vector<RemoteReceiverListener *> listeners_;
+                uint8_t tolerance_;
+        };
+
+        class RemoteTransmitterBase {
+            public:
+                class TransmitCall {
+                    public:
+                        explicit TransmitCall(RemoteTransmitterBase *parent) : parent_(parent) {}
+                        RemoteTransmitData *get_data() { return &this->parent_->temp_; }
+                        void set_send_times(uint32_t send_times) { this->send_times_ = send_times; }
+                        void set_send_wait(uint32_t send_wait) { this->send_wait_ = send_wait; }
+                        void perform() { this->parent_->send_(this->send_times_, this->send_wait_); }
+
+                    protected:
+                        RemoteTransmitterBase *parent_;
+                        uint32_t send_times_{1};
+                        uint32_t send_wait_{0};
+                };
+
+                virtual ~RemoteTransmitterBase() = default;
+
+                TransmitCall transmit() {
+                    this->temp_.reset();
+                    return TransmitCall(this);
+                }
+
+            protected:
+                virtual void send_internal(uint32_t send_times, uint32_t send_wait) = 0;
+                void send_(uint32_t send_times, uint32_t send_wait) { this->send_internal(send_times, send_wait); }
+
+                RemoteTransmitData temp_;
+        };
+    }
+}
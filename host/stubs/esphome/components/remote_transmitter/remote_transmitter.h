@@ -0,0 +1,34 @@
+#pragma once
+
+// Host stand-in for esphome/components/remote_transmitter.
+// Instead of driving an LED it keeps the last burst and hands every burst to an optional sink.
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "esphome/core/component.h"
+#include "esphome/components/remote_base/remote_base.h"
+
+namespace esphome {
+    namespace remote_transmitter {
+        class RemoteTransmitterComponent : public remote_base::RemoteTransmitterBase, public Component {
+            public:
+                using Sink = std::function<void(const remote_base::RemoteTransmitData &data, uint32_t send_times, uint32_t send_wait)>;
+
+                void set_sink(Sink sink) { this->sink_ = std::move(sink); }
+                const remote_base::RemoteTransmitData &get_last_data() const { return this->temp_; }
+                uint32_t get_transmit_count() const { return this->transmit_count_; }
+
+            protected:
+                void send_internal(uint32_t send_times, uint32_t send_wait) override {
+                    this->transmit_count_ += 1;
+                    if (this->sink_) {
+                        this->sink_(this->temp_, send_times, send_wait);
+                    }
+                }
+
+                Sink sink_;
+                uint32_t transmit_count_{0};
+        };
+    }
+}
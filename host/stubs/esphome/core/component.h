@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for esphome/core/component.h.
+// Timeouts and intervals run off the simulated clock in esphome/core/hal.h, see host::advance().
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace esphome {
+    class Component {
+        public:
+            virtual ~Component();
+
+            virtual void setup() {}
+            virtual void loop() {}
+            virtual void dump_config() {}
+
+        protected:
+            void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+            bool cancel_timeout(const std::string &name);
+            void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+            bool cancel_interval(const std::string &name);
+    };
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Host stand-in for esphome/core/hal.h.
+// millis() is a simulated clock so scheduler behaviour is deterministic,
+// micros() follows the wall clock so code timing still means something.
+
+#include <cstdint>
+
+namespace esphome {
+    uint32_t millis();
+    uint32_t micros();
+
+    namespace host {
+        // Moves the simulated clock forward, running every timeout and interval that falls due on the way.
+        void advance(uint32_t ms);
+    }
+}
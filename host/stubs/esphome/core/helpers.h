@@ -0,0 +1,48 @@
+#pragma once
+
+// Host stand-in for the bits of esphome/core/helpers.h this component uses.
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <optional>
+#include <algorithm>
+
+namespace esphome {
+    template<typename T> using optional = std::optional<T>;
+
+    template<typename T> T clamp(T value, T min, T max) {
+        return std::min(std::max(value, min), max);
+    }
+
+    inline uint32_t fnv1_hash(const std::string &str) {
+        uint32_t hash = 2166136261UL;
+        for (char c : str) {
+            hash *= 16777619UL;
+            hash ^= c;
+        }
+        return hash;
+    }
+
+    inline char format_hex_char(uint8_t v) {
+        return v >= 10 ? 'a' + (v - 10) : '0' + v;
+    }
+
+    inline std::string format_hex(const uint8_t *data, size_t length) {
+        std::string ret;
+        ret.resize(length * 2);
+        for (size_t i = 0; i < length; i++) {
+            ret[2 * i] = format_hex_char((data[i] & 0xF0) >> 4);
+            ret[2 * i + 1] = format_hex_char(data[i] & 0x0F);
+        }
+        return ret;
+    }
+
+    template<typename T> std::string format_hex(T val) {
+        uint8_t bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = static_cast<uint8_t>(val >> (8 * (sizeof(T) - 1 - i)));
+        }
+        return format_hex(bytes, sizeof(T));
+    }
+}
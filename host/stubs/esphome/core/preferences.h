@@ -0,0 +1,58 @@
+#pragma once
+
+// Host stand-in for esphome/core/preferences.h.
+// Preferences live in memory for the life of the process, and every save is counted so flash wear can be measured.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace esphome {
+    class ESPPreferenceObject {
+        public:
+            ESPPreferenceObject() = default;
+            explicit ESPPreferenceObject(std::vector<uint8_t> *storage) : storage_(storage) {}
+
+            template<typename T> bool save(const T *src) {
+                if (this->storage_ == nullptr) {
+                    return false;
+                }
+                this->storage_->assign(reinterpret_cast<const uint8_t *>(src), reinterpret_cast<const uint8_t *>(src) + sizeof(T));
+                save_count += 1;
+                return true;
+            }
+
+            template<typename T> bool load(T *dest) {
+                if (this->storage_ == nullptr || this->storage_->size() != sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(dest, this->storage_->data(), sizeof(T));
+                return true;
+            }
+
+            // Host only: saves across every preference.
+            static uint32_t save_count;
+
+        protected:
+            std::vector<uint8_t> *storage_{nullptr};
+    };
+
+    class ESPPreferences {
+        public:
+            template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = false) {
+                return ESPPreferenceObject(&this->storage_[type]);
+            }
+
+            bool sync() { return true; }
+
+            // Host only: forget everything, as if the flash had been erased.
+            void reset() { this->storage_.clear(); }
+
+        protected:
+            std::map<uint32_t, std::vector<uint8_t>> storage_;
+    };
+
+    extern ESPPreferences *global_preferences;
+}
@@ -0,0 +1,128 @@
+// Definitions backing the host stand-ins.
+
+#include <chrono>
+#include <cstdio>
+#include <list>
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+namespace esphome {
+    namespace host {
+        int log_level = ESPHOME_LOG_LEVEL_WARN;
+
+        static const auto start = std::chrono::steady_clock::now();
+        static uint32_t now = 0;
+
+        struct Task {
+            Component *owner;
+            std::string name;
+            bool interval;
+            uint32_t period;
+            uint32_t due;
+            std::function<void()> f;
+            bool removed;
+        };
+
+        static std::list<Task> tasks;
+
+        static bool cancel(Component *owner, const std::string &name, bool interval) {
+            bool found = false;
+            for (Task &task : tasks) {
+                if (!task.removed && task.owner == owner && task.name == name && task.interval == interval) {
+                    task.removed = true;
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        static void schedule(Component *owner, const std::string &name, bool interval, uint32_t period, std::function<void()> &&f) {
+            cancel(owner, name, interval);
+            tasks.push_back({owner, name, interval, period, now + period, std::move(f), false});
+        }
+
+        void advance(uint32_t ms) {
+            const uint32_t target = now + ms;
+            while (true) {
+                Task *next = nullptr;
+                for (Task &task : tasks) {
+                    if (!task.removed && static_cast<int32_t>(task.due - target) <= 0 &&
+                        (next == nullptr || static_cast<int32_t>(task.due - next->due) < 0)) {
+                        next = &task;
+                    }
+                }
+                if (next == nullptr) {
+                    break;
+                }
+
+                now = next->due;
+                if (next->interval) {
+                    next->due += next->period;
+                } else {
+                    next->removed = true;
+                }
+                // The callback may schedule more work, so run a copy.
+                std::function<void()> f = next->f;
+                f();
+
+                tasks.remove_if([](const Task &task) { return task.removed; });
+            }
+            now = target;
+        }
+    }
+
+    Component::~Component() {
+        for (host::Task &task : host::tasks) {
+            if (task.owner == this) {
+                task.removed = true;
+            }
+        }
+        host::tasks.remove_if([](const host::Task &task) { return task.removed; });
+    }
+
+    void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+        host::schedule(this, name, false, timeout, std::move(f));
+    }
+
+    bool Component::cancel_timeout(const std::string &name) {
+        return host::cancel(this, name, false);
+    }
+
+    void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+        host::schedule(this, name, true, interval, std::move(f));
+    }
+
+    bool Component::cancel_interval(const std::string &name) {
+        return host::cancel(this, name, true);
+    }
+
+    void esp_log_printf_(int level, const char *tag, int line, const char *format, ...) {
+        if (level > host::log_level) {
+            return;
+        }
+
+        static const char LETTERS[] = {' ', 'E', 'W', 'I', 'C', 'D', 'V', 'V'};
+        std::fprintf(stderr, "[%c][%s:%03d]: ", LETTERS[level], tag, line);
+
+        va_list arg;
+        va_start(arg, format);
+        std::vfprintf(stderr, format, arg);
+        va_end(arg);
+
+        std::fputc('\n', stderr);
+    }
+
+    static ESPPreferences preferences;
+    ESPPreferences *global_preferences = &preferences;
+    uint32_t ESPPreferenceObject::save_count = 0;
+
+    uint32_t millis() {
+        return host::now;
+    }
+
+    uint32_t micros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - host::start).count();
+    }
+}